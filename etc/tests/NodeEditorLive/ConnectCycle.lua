@@ -0,0 +1,150 @@
+root=
+{
+	items=
+	{
+		{
+			cmd="COMMAND_CREATE_NODE",
+			nodeClass="GroupTyped",
+			nodeName="group1",
+			status=
+			{
+				statusCode="STATUS_OK",
+				resultType="RESULT_NODE_ID",
+				nodeID=0,
+			},
+			assertions=
+			{
+				{
+					path="graph.numNodes",
+					value=1,
+					typeIndex="TYPE_UINT",
+					op="RELOP_EQ",
+				},
+			},
+		},
+		{
+			cmd="COMMAND_CREATE_NODE",
+			nodeClass="GroupTyped",
+			nodeName="group2",
+			status=
+			{
+				statusCode="STATUS_OK",
+				resultType="RESULT_NODE_ID",
+				nodeID=1,
+			},
+			assertions=
+			{
+				{
+					path="graph.numNodes",
+					value=2,
+					typeIndex="TYPE_UINT",
+					op="RELOP_EQ",
+				},
+			},
+		},
+		{
+			cmd="COMMAND_CREATE_NODE",
+			nodeClass="GroupTyped",
+			nodeName="group3",
+			status=
+			{
+				statusCode="STATUS_OK",
+				resultType="RESULT_NODE_ID",
+				nodeID=2,
+			},
+			assertions=
+			{
+				{
+					path="graph.numNodes",
+					value=3,
+					typeIndex="TYPE_UINT",
+					op="RELOP_EQ",
+				},
+			},
+		},
+		{
+			cmd="COMMAND_CONNECT",
+			fromPort=4,
+			toPort=3,
+			status=
+			{
+				statusCode="STATUS_OK",
+				resultType="RESULT_SIGNAL_PATH_ID",
+				signalPathID=0,
+			},
+			assertions=
+			{
+				{
+					path="order.numNodes",
+					value=3,
+					typeIndex="TYPE_UINT",
+					op="RELOP_EQ",
+				},
+				{
+					path="order.numReordered",
+					value=2,
+					typeIndex="TYPE_UINT",
+					op="RELOP_EQ",
+				},
+			},
+		},
+		{
+			cmd="COMMAND_CONNECT",
+			fromPort=2,
+			toPort=1,
+			status=
+			{
+				statusCode="STATUS_OK",
+				resultType="RESULT_SIGNAL_PATH_ID",
+				signalPathID=1,
+			},
+			assertions=
+			{
+				{
+					path="order.numReordered",
+					value=5,
+					typeIndex="TYPE_UINT",
+					op="RELOP_EQ",
+				},
+			},
+		},
+		{
+			cmd="COMMAND_CONNECT",
+			fromPort=0,
+			toPort=5,
+			status=
+			{
+				statusCode="STATUS_CYCLE_DETECTED",
+				resultType="RESULT_NODE_ID",
+				nodeID=0,
+			},
+			assertions=
+			{
+				{
+					path="graph.ports[0].numOutgoingConnections",
+					value=0,
+					typeIndex="TYPE_UINT",
+					op="RELOP_EQ",
+				},
+				{
+					path="graph.ports[5].numIncomingConnections",
+					value=0,
+					typeIndex="TYPE_UINT",
+					op="RELOP_EQ",
+				},
+				{
+					path="graph.numSignalPaths",
+					value=2,
+					typeIndex="TYPE_UINT",
+					op="RELOP_EQ",
+				},
+				{
+					path="order.numRebuilds",
+					value=0,
+					typeIndex="TYPE_UINT",
+					op="RELOP_EQ",
+				},
+			},
+		},
+	}
+}
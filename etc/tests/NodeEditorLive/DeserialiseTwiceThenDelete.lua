@@ -0,0 +1,115 @@
+root=
+{
+	items=
+	{
+		{
+			cmd="COMMAND_CREATE_NODE",
+			nodeClass="GroupTyped",
+			nodeName="group1",
+			status=
+			{
+				statusCode="STATUS_OK",
+				resultType="RESULT_NODE_ID",
+				nodeID=0,
+			},
+		},
+		{
+			cmd="COMMAND_CREATE_NODE",
+			nodeClass="FooTyped",
+			nodeName="foo1",
+			status=
+			{
+				statusCode="STATUS_OK",
+				resultType="RESULT_NODE_ID",
+				nodeID=1,
+			},
+		},
+		{
+			cmd="COMMAND_CONNECT",
+			fromPort=0,
+			toPort=2,
+			status=
+			{
+				statusCode="STATUS_OK",
+				resultType="RESULT_SIGNAL_PATH_ID",
+				signalPathID=0,
+			},
+			assertions=
+			{
+				{
+					path="numTransfers",
+					value=1,
+					typeIndex="TYPE_UINT",
+					op="RELOP_EQ",
+				},
+			},
+		},
+		{
+			cmd="COMMAND_SERIALISE",
+			filename="scratch/DeserialiseTwiceThenDelete.txt",
+		},
+		{
+			cmd="COMMAND_DESERIALISE",
+			filename="scratch/DeserialiseTwiceThenDelete.txt",
+			assertions=
+			{
+				{
+					path="graph.numSignalPaths",
+					value=1,
+					typeIndex="TYPE_UINT",
+					op="RELOP_EQ",
+				},
+				{
+					path="numTransfers",
+					value=0,
+					typeIndex="TYPE_UINT",
+					op="RELOP_EQ",
+				},
+			},
+		},
+		{
+			cmd="COMMAND_DESERIALISE",
+			filename="scratch/DeserialiseTwiceThenDelete.txt",
+			assertions=
+			{
+				{
+					path="numTransfers",
+					value=0,
+					typeIndex="TYPE_UINT",
+					op="RELOP_EQ",
+				},
+			},
+		},
+		{
+			cmd="COMMAND_DELETE_NODE",
+			node=1,
+			status=
+			{
+				statusCode="STATUS_OK",
+				resultType="RESULT_NODE_ID",
+				nodeID=1,
+			},
+			assertions=
+			{
+				{
+					path="graph.numNodes",
+					value=1,
+					typeIndex="TYPE_UINT",
+					op="RELOP_EQ",
+				},
+				{
+					path="graph.numSignalPaths",
+					value=0,
+					typeIndex="TYPE_UINT",
+					op="RELOP_EQ",
+				},
+				{
+					path="numTransfers",
+					value=0,
+					typeIndex="TYPE_UINT",
+					op="RELOP_EQ",
+				},
+			},
+		},
+	}
+}
@@ -0,0 +1,161 @@
+root=
+{
+	items=
+	{
+		{
+			cmd="COMMAND_CREATE_NODE",
+			nodeClass="MathsNode",
+			nodeName="maths1",
+			status=
+			{
+				statusCode="STATUS_OK",
+				resultType="RESULT_NODE_ID",
+				nodeID=0,
+			},
+		},
+		{
+			cmd="COMMAND_CREATE_NODE",
+			nodeClass="MathsNode",
+			nodeName="maths2",
+			status=
+			{
+				statusCode="STATUS_OK",
+				resultType="RESULT_NODE_ID",
+				nodeID=1,
+			},
+		},
+		{
+			cmd="COMMAND_CREATE_NODE",
+			nodeClass="MathsNode",
+			nodeName="maths3",
+			status=
+			{
+				statusCode="STATUS_OK",
+				resultType="RESULT_NODE_ID",
+				nodeID=2,
+			},
+		},
+		{
+			cmd="COMMAND_CREATE_NODE",
+			nodeClass="MathsNode",
+			nodeName="maths4",
+			status=
+			{
+				statusCode="STATUS_OK",
+				resultType="RESULT_NODE_ID",
+				nodeID=3,
+			},
+		},
+		{
+			cmd="COMMAND_CONNECT",
+			fromPort=2,
+			toPort=3,
+			status=
+			{
+				statusCode="STATUS_OK",
+				resultType="RESULT_SIGNAL_PATH_ID",
+				signalPathID=0,
+			},
+		},
+		{
+			cmd="COMMAND_CONNECT",
+			fromPort=5,
+			toPort=6,
+			status=
+			{
+				statusCode="STATUS_OK",
+				resultType="RESULT_SIGNAL_PATH_ID",
+				signalPathID=1,
+			},
+		},
+		-- The first evaluation after a compile updates every Node.
+		{
+			cmd="COMMAND_EVALUATE_DIRTY",
+			assertions=
+			{
+				{
+					path="plan.numUpdated",
+					value=4,
+					typeIndex="TYPE_UINT",
+					op="RELOP_EQ",
+				},
+			},
+		},
+		-- Nothing changed.
+		{
+			cmd="COMMAND_EVALUATE_DIRTY",
+			assertions=
+			{
+				{
+					path="plan.numUpdated",
+					value=0,
+					typeIndex="TYPE_UINT",
+					op="RELOP_EQ",
+				},
+			},
+		},
+		-- A new angle at the head of the chain reaches every Node in the chain.
+		{
+			cmd="COMMAND_SET_VALUE",
+			port=0,
+			value=0.5,
+		},
+		{
+			cmd="COMMAND_EVALUATE_DIRTY",
+			assertions=
+			{
+				{
+					path="plan.numUpdated",
+					value=3,
+					typeIndex="TYPE_UINT",
+					op="RELOP_EQ",
+				},
+			},
+		},
+		-- The same angle again does not change the output, so propagation stops.
+		{
+			cmd="COMMAND_SET_VALUE",
+			port=0,
+			value=0.5,
+		},
+		{
+			cmd="COMMAND_EVALUATE_DIRTY",
+			assertions=
+			{
+				{
+					path="plan.numUpdated",
+					value=1,
+					typeIndex="TYPE_UINT",
+					op="RELOP_EQ",
+				},
+			},
+		},
+		-- The unconnected Node is independent of the chain.
+		{
+			cmd="COMMAND_SET_VALUE",
+			port=9,
+			value=1.0,
+		},
+		{
+			cmd="COMMAND_EVALUATE_DIRTY",
+			assertions=
+			{
+				{
+					path="plan.numUpdated",
+					value=1,
+					typeIndex="TYPE_UINT",
+					op="RELOP_EQ",
+				},
+			},
+		},
+		{
+			cmd="COMMAND_SET_VALUE",
+			port=100,
+			value=1.0,
+			status=
+			{
+				statusCode="STATUS_OBJECT_NOT_FOUND",
+			},
+		},
+	}
+}
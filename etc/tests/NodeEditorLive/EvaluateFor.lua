@@ -0,0 +1,202 @@
+root=
+{
+	items=
+	{
+		{
+			cmd="COMMAND_CREATE_NODE",
+			nodeClass="MathsNode",
+			nodeName="maths1",
+			status=
+			{
+				statusCode="STATUS_OK",
+				resultType="RESULT_NODE_ID",
+				nodeID=0,
+			},
+		},
+		{
+			cmd="COMMAND_CREATE_NODE",
+			nodeClass="MathsNode",
+			nodeName="maths2",
+			status=
+			{
+				statusCode="STATUS_OK",
+				resultType="RESULT_NODE_ID",
+				nodeID=1,
+			},
+		},
+		{
+			cmd="COMMAND_CREATE_NODE",
+			nodeClass="MathsNode",
+			nodeName="maths3",
+			status=
+			{
+				statusCode="STATUS_OK",
+				resultType="RESULT_NODE_ID",
+				nodeID=2,
+			},
+		},
+		{
+			cmd="COMMAND_CREATE_NODE",
+			nodeClass="MathsNode",
+			nodeName="maths4",
+			status=
+			{
+				statusCode="STATUS_OK",
+				resultType="RESULT_NODE_ID",
+				nodeID=3,
+			},
+		},
+		{
+			cmd="COMMAND_CONNECT",
+			fromPort=2,
+			toPort=3,
+			status=
+			{
+				statusCode="STATUS_OK",
+				resultType="RESULT_SIGNAL_PATH_ID",
+				signalPathID=0,
+			},
+		},
+		{
+			cmd="COMMAND_CONNECT",
+			fromPort=5,
+			toPort=6,
+			status=
+			{
+				statusCode="STATUS_OK",
+				resultType="RESULT_SIGNAL_PATH_ID",
+				signalPathID=1,
+			},
+		},
+		-- The output of the second Node in the chain needs the first two Nodes.
+		{
+			cmd="COMMAND_EVALUATE_FOR",
+			port=5,
+			assertions=
+			{
+				{
+					path="plan.numCompiles",
+					value=1,
+					typeIndex="TYPE_UINT",
+					op="RELOP_EQ",
+				},
+				{
+					path="plan.numUpdated",
+					value=2,
+					typeIndex="TYPE_UINT",
+					op="RELOP_EQ",
+				},
+				{
+					path="plan.numCones",
+					value=1,
+					typeIndex="TYPE_UINT",
+					op="RELOP_EQ",
+				},
+			},
+		},
+		-- The cone is reused.
+		{
+			cmd="COMMAND_EVALUATE_FOR",
+			port=5,
+			assertions=
+			{
+				{
+					path="plan.numCompiles",
+					value=1,
+					typeIndex="TYPE_UINT",
+					op="RELOP_EQ",
+				},
+				{
+					path="plan.numCones",
+					value=1,
+					typeIndex="TYPE_UINT",
+					op="RELOP_EQ",
+				},
+			},
+		},
+		{
+			cmd="COMMAND_EVALUATE_FOR",
+			port=8,
+			assertions=
+			{
+				{
+					path="plan.numUpdated",
+					value=3,
+					typeIndex="TYPE_UINT",
+					op="RELOP_EQ",
+				},
+				{
+					path="plan.numCones",
+					value=2,
+					typeIndex="TYPE_UINT",
+					op="RELOP_EQ",
+				},
+			},
+		},
+		-- The unconnected Node is a cone by itself.
+		{
+			cmd="COMMAND_EVALUATE_FOR",
+			port=11,
+			assertions=
+			{
+				{
+					path="plan.numUpdated",
+					value=1,
+					typeIndex="TYPE_UINT",
+					op="RELOP_EQ",
+				},
+				{
+					path="plan.numCones",
+					value=3,
+					typeIndex="TYPE_UINT",
+					op="RELOP_EQ",
+				},
+			},
+		},
+		-- Editing the topology discards the cached cones.
+		{
+			cmd="COMMAND_CONNECT",
+			fromPort=11,
+			toPort=0,
+			status=
+			{
+				statusCode="STATUS_OK",
+				resultType="RESULT_SIGNAL_PATH_ID",
+				signalPathID=2,
+			},
+		},
+		{
+			cmd="COMMAND_EVALUATE_FOR",
+			port=8,
+			assertions=
+			{
+				{
+					path="plan.numCompiles",
+					value=2,
+					typeIndex="TYPE_UINT",
+					op="RELOP_EQ",
+				},
+				{
+					path="plan.numUpdated",
+					value=4,
+					typeIndex="TYPE_UINT",
+					op="RELOP_EQ",
+				},
+				{
+					path="plan.numCones",
+					value=1,
+					typeIndex="TYPE_UINT",
+					op="RELOP_EQ",
+				},
+			},
+		},
+		{
+			cmd="COMMAND_EVALUATE_FOR",
+			port=100,
+			status=
+			{
+				statusCode="STATUS_OBJECT_NOT_FOUND",
+			},
+		},
+	}
+}
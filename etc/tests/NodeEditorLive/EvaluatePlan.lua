@@ -0,0 +1,102 @@
+root=
+{
+	items=
+	{
+		{
+			cmd="COMMAND_CREATE_NODE",
+			nodeClass="GroupTyped",
+			nodeName="group1",
+			status=
+			{
+				statusCode="STATUS_OK",
+				resultType="RESULT_NODE_ID",
+				nodeID=0,
+			},
+		},
+		{
+			cmd="COMMAND_CREATE_NODE",
+			nodeClass="GroupTyped",
+			nodeName="group2",
+			status=
+			{
+				statusCode="STATUS_OK",
+				resultType="RESULT_NODE_ID",
+				nodeID=1,
+			},
+		},
+		{
+			cmd="COMMAND_CONNECT",
+			fromPort=0,
+			toPort=3,
+			status=
+			{
+				statusCode="STATUS_OK",
+				resultType="RESULT_SIGNAL_PATH_ID",
+				signalPathID=0,
+			},
+		},
+		{
+			cmd="COMMAND_EVALUATE",
+			assertions=
+			{
+				{
+					path="plan.numCompiles",
+					value=1,
+					typeIndex="TYPE_UINT",
+					op="RELOP_EQ",
+				},
+				{
+					path="plan.numNodes",
+					value=2,
+					typeIndex="TYPE_UINT",
+					op="RELOP_EQ",
+				},
+				{
+					path="plan.numTransfers",
+					value=1,
+					typeIndex="TYPE_UINT",
+					op="RELOP_EQ",
+				},
+				{
+					path="graph.nodes[1].dynamicPort[1].value",
+					value=1.0,
+					op="RELOP_EQ",
+				},
+			},
+		},
+		{
+			cmd="COMMAND_EVALUATE",
+			assertions=
+			{
+				{
+					path="plan.numCompiles",
+					value=1,
+					typeIndex="TYPE_UINT",
+					op="RELOP_EQ",
+				},
+			},
+		},
+		{
+			cmd="COMMAND_DISCONNECT",
+			signalPath=0,
+		},
+		{
+			cmd="COMMAND_EVALUATE",
+			assertions=
+			{
+				{
+					path="plan.numCompiles",
+					value=2,
+					typeIndex="TYPE_UINT",
+					op="RELOP_EQ",
+				},
+				{
+					path="plan.numTransfers",
+					value=0,
+					typeIndex="TYPE_UINT",
+					op="RELOP_EQ",
+				},
+			},
+		},
+	}
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "config/Export.h"
+
+#include "core/Types.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+
+namespace dagbase
+{
+    class Port;
+}
+
+namespace dag
+{
+    class BatchContext;
+
+    //! A Node that can update a whole batch of samples in one call.
+    //! Nodes that do not implement it are evaluated one sample at a time through update().
+    class DAG_API BatchNode
+    {
+    public:
+        virtual ~BatchNode() = default;
+
+        //! Update n samples, reading and writing the arrays that context holds for our Ports.
+        virtual void updateBatch(BatchContext& context, std::size_t n) = 0;
+    };
+
+    //! Structure-of-arrays storage for batch evaluation.
+    //! Every double and int64 Port that is added gets a contiguous array of size() values
+    //! aligned for SIMD loads, other Ports keep a single value shared by every sample.
+    class DAG_API BatchContext
+    {
+    public:
+        static constexpr std::size_t alignment = 64;
+    public:
+        BatchContext() = default;
+
+        BatchContext(const BatchContext&) = delete;
+
+        BatchContext& operator=(const BatchContext&) = delete;
+
+        ~BatchContext();
+
+        //! Forget every Port and set the number of samples for the next commit().
+        void reset(std::size_t size);
+
+        //! Reserve an array for port if it has a batchable type, ignored for other Ports and duplicates.
+        void addPort(const dagbase::Port& port);
+
+        //! Let dest read the array of source instead of having its own, so that a transfer
+        //! between them has nothing to copy. Call after addPort() for both and before commit().
+        //! \return true if both Ports have arrays of the same type, otherwise nothing changes.
+        bool alias(const dagbase::Port& dest, const dagbase::Port& source);
+
+        //! Allocate the arrays and fill each one with the current value of its Port.
+        void commit();
+
+        [[nodiscard]]std::size_t size() const
+        {
+            return _size;
+        }
+
+        //! \return The number of Ports with an array, including those that alias another.
+        [[nodiscard]]std::size_t numArrays() const
+        {
+            return _slots.size();
+        }
+
+        [[nodiscard]]std::size_t numAliases() const
+        {
+            return _numAliases;
+        }
+
+        //! \return The samples of a double Port, or nullptr if it has no array.
+        [[nodiscard]]double* doubles(const dagbase::Port& port) const
+        {
+            return static_cast<double*>(data(port, dagbase::PortType::TYPE_DOUBLE));
+        }
+
+        //! \return The samples of an int64 Port, or nullptr if it has no array.
+        [[nodiscard]]std::int64_t* int64s(const dagbase::Port& port) const
+        {
+            return static_cast<std::int64_t*>(data(port, dagbase::PortType::TYPE_INT64));
+        }
+
+        //! \return The samples of port if it has an array of the given type, otherwise nullptr.
+        [[nodiscard]]void* data(const dagbase::Port& port, dagbase::PortType::Type type) const;
+    private:
+        struct Slot
+        {
+            dagbase::PortType::Type type{dagbase::PortType::TYPE_UNKNOWN};
+            std::size_t offset{0};
+            //! The Port whose array we share, nullptr if we own one.
+            const dagbase::Port* alias{nullptr};
+        };
+
+        std::unordered_map<const dagbase::Port*, Slot> _slots;
+        unsigned char* _block{nullptr};
+        std::size_t _size{0};
+        std::size_t _stride{0};
+        std::size_t _numAliases{0};
+        bool _committed{false};
+    };
+}
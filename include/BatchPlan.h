@@ -0,0 +1,91 @@
+#pragma once
+
+#include "config/Export.h"
+
+#include "core/Types.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace dagbase
+{
+    class Port;
+}
+
+namespace dag
+{
+    class BatchContext;
+    class BatchNode;
+    class EvaluationPlan;
+
+    //! The arrays of samples that each transfer and Port of an EvaluationPlan reads and writes
+    //! when evaluating a batch, see EvaluationPlan::prepareBatch().
+    class DAG_API BatchPlan
+    {
+    public:
+        //! Choose whether prepare() lets an input read the array of the output connected to it
+        //! when both have the same type, so that evaluate() copies samples only where a conversion is needed.
+        void setZeroCopy(bool zeroCopy)
+        {
+            _zeroCopy = zeroCopy;
+        }
+
+        //! Give every double and int64 Port of plan an array of n samples in context.
+        void prepare(const EvaluationPlan& plan, BatchContext& context, std::size_t n);
+
+        //! Forget the arrays, typically because plan was compiled again.
+        void reset()
+        {
+            _context = nullptr;
+        }
+
+        [[nodiscard]]bool isPrepared() const
+        {
+            return _context != nullptr;
+        }
+
+        //! Evaluate every sample of every live Node of plan.
+        //! \pre isPrepared()
+        void evaluate(const EvaluationPlan& plan) const;
+
+        [[nodiscard]]std::uint32_t numAliased() const
+        {
+            return _numAliased;
+        }
+    private:
+        void transfer(const EvaluationPlan& plan, std::size_t index, std::size_t n) const;
+
+        void updateSamples(const EvaluationPlan& plan, std::size_t index, std::size_t n) const;
+
+        //! The arrays at either end of a transfer, nullptr if the Port has none.
+        struct BatchTransfer
+        {
+            void* source{nullptr};
+            void* dest{nullptr};
+            dagbase::PortType::Type sourceType{dagbase::PortType::TYPE_UNKNOWN};
+            dagbase::PortType::Type destType{dagbase::PortType::TYPE_UNKNOWN};
+            //! The destination reads the source array, so there is nothing to copy.
+            bool aliased{false};
+        };
+
+        //! A Port of a Node without updateBatch() and the array that feeds or receives it.
+        struct BatchPort
+        {
+            dagbase::Port* port{nullptr};
+            void* data{nullptr};
+            dagbase::PortType::Type type{dagbase::PortType::TYPE_UNKNOWN};
+            bool isOutput{false};
+            bool isTyped{false};
+        };
+
+        BatchContext* _context{nullptr};
+        std::vector<BatchNode*> _batchNodes;
+        std::vector<BatchTransfer> _transfers;
+        //! The Ports of Node i are [_firstPort[i], _firstPort[i+1]) in _ports
+        std::vector<std::uint32_t> _firstPort;
+        std::vector<BatchPort> _ports;
+        std::uint32_t _numAliased{0};
+        bool _zeroCopy{true};
+    };
+}
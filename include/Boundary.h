@@ -101,6 +101,13 @@ namespace dag
         }
 
         void debug(dagbase::DebugPrinter& printer) const override;
+
+        //! \return The Port on the other side of the Boundary from port, or nullptr if it has none.
+        //! \note The k-th input is paired with the k-th output, in the order they were added.
+        [[nodiscard]]dagbase::Port* partner(const dagbase::Port& port) const;
+
+        //! Copy the value of each input to its partner output.
+        void update() override;
     private:
         MetaPortArray _dynamicMetaPorts;
         PortArray _dynamicPorts;
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "config/Export.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace dag
+{
+    class EvaluationPlan;
+    class MathsNode;
+
+    //! The chains of MathsNode in an EvaluationPlan that run as one kernel.
+    //! A chain is a run of MathsNode each fed only by the output of the one before. The kernel keeps
+    //! the value in a register from link to link and writes every Port of the chain directly, so the
+    //! Ports read the same as without fusion but there is no update() or transfer per link.
+    class DAG_API ChainFusion
+    {
+    public:
+        typedef std::vector<std::uint32_t> IndexArray;
+
+        //! The chain of a Node that heads none.
+        static constexpr std::uint32_t NO_CHAIN = ~std::uint32_t{0};
+    public:
+        void setEnabled(bool enabled)
+        {
+            _enabled = enabled;
+        }
+
+        [[nodiscard]]bool isEnabled() const
+        {
+            return _enabled;
+        }
+
+        //! Find the chains of plan.
+        //! \param fusable Per Node, 1 if the Node may be a link, because it runs whenever its producer does.
+        //! \param region Per Node, a value that the two ends of a link must share, such as the memo that skips them.
+        void compile(const EvaluationPlan& plan, const std::vector<std::uint8_t>& fusable, const IndexArray& region);
+
+        //! \return The chain headed by the Node at index, or NO_CHAIN.
+        [[nodiscard]]std::uint32_t chainOf(std::size_t index) const
+        {
+            return _chainOf.empty() ? NO_CHAIN : _chainOf[index];
+        }
+
+        //! \return true if the Node at index is run by the kernel of an earlier head.
+        [[nodiscard]]bool isFused(std::size_t index) const
+        {
+            return !_fused.empty() && _fused[index] != 0;
+        }
+
+        [[nodiscard]]std::uint32_t head(std::uint32_t chain) const
+        {
+            return _chains[chain].nodes.front();
+        }
+
+        //! \return The index of each link of chain, the head first.
+        [[nodiscard]]const IndexArray& links(std::uint32_t chain) const
+        {
+            return _chains[chain].nodes;
+        }
+
+        //! Run the kernel of a chain, whose head already has its inputs.
+        void run(std::uint32_t chain) const;
+
+        [[nodiscard]]std::size_t numChains() const
+        {
+            return _chains.size();
+        }
+
+        [[nodiscard]]std::uint32_t numFused() const
+        {
+            return _numFused;
+        }
+    private:
+        //! A run of MathsNode in plan order, the first of which is fed by transfers
+        struct Chain
+        {
+            std::vector<MathsNode*> links;
+            //! The index of each link, the head first
+            IndexArray nodes;
+        };
+        std::vector<Chain> _chains;
+        //! Per Node, the Chain it heads or NO_CHAIN. Empty when nothing is fused.
+        IndexArray _chainOf;
+        //! Per Node, 1 if it is evaluated by the kernel of an earlier head
+        std::vector<std::uint8_t> _fused;
+        std::uint32_t _numFused{0};
+        bool _enabled{false};
+    };
+}
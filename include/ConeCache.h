@@ -0,0 +1,36 @@
+#pragma once
+
+#include "config/Export.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace dag
+{
+    class EvaluationPlan;
+
+    //! The upstream cone of each Node of an EvaluationPlan that was asked for, kept until the next compile.
+    class DAG_API ConeCache
+    {
+    public:
+        typedef std::vector<std::uint32_t> IndexArray;
+    public:
+        //! \return The plan indices upstream of the Node at index, inclusive and ascending, which is topological.
+        const IndexArray& coneFor(const EvaluationPlan& plan, std::uint32_t index);
+
+        void clear()
+        {
+            _cones.clear();
+        }
+
+        [[nodiscard]]std::size_t size() const
+        {
+            return _cones.size();
+        }
+    private:
+        //! Keyed by Node index
+        std::unordered_map<std::uint32_t, IndexArray> _cones;
+    };
+}
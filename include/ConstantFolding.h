@@ -0,0 +1,67 @@
+#pragma once
+
+#include "config/Export.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace dag
+{
+    class EvaluationPlan;
+
+    //! The constant Nodes of an EvaluationPlan and whether each is up to date.
+    //! A Node is constant when it is not a source and every input is unconnected or fed by
+    //! constant Nodes. A constant Node is updated once and then skipped until it is unfolded.
+    //! Every producer of a constant Node is constant, so the constant Nodes downstream of one
+    //! are reached through constant Nodes alone.
+    class DAG_API ConstantFolding
+    {
+    public:
+        void setEnabled(bool enabled)
+        {
+            _enabled = enabled;
+        }
+
+        [[nodiscard]]bool isEnabled() const
+        {
+            return _enabled;
+        }
+
+        //! Find the constant Nodes of plan, none of which is up to date yet.
+        void compile(const EvaluationPlan& plan);
+
+        [[nodiscard]]bool isFolded(std::size_t index) const
+        {
+            return _folded[index] != 0;
+        }
+
+        //! \return true if the Node at index is constant and already up to date, so it can be skipped.
+        [[nodiscard]]bool isCurrent(std::size_t index) const
+        {
+            return _current[index] != 0;
+        }
+
+        //! Record that the Node at index was updated. A constant Node refolds only once every
+        //! producer is up to date again, so a Node unfolded with its producer is not left behind.
+        //! \note Safe to call concurrently for Nodes of the same level.
+        void markUpdated(const EvaluationPlan& plan, std::size_t index) const;
+
+        //! Update the constant Node at index and the constant Nodes downstream of it again on their next
+        //! evaluation, typically because an input of the Node was set. Each of them refolds once it is updated.
+        //! \note Other constant Nodes stay up to date.
+        void unfold(const EvaluationPlan& plan, std::uint32_t index);
+
+        [[nodiscard]]std::uint32_t numFolded() const
+        {
+            return _numFolded;
+        }
+    private:
+        //! Per Node, 1 if the Node is constant
+        std::vector<std::uint8_t> _folded;
+        //! Per Node, 1 if the Node is constant and already up to date
+        mutable std::vector<std::uint8_t> _current;
+        std::uint32_t _numFolded{0};
+        bool _enabled{false};
+    };
+}
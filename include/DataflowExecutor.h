@@ -0,0 +1,105 @@
+#pragma once
+
+#include "config/Export.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace dag
+{
+    class EvaluationPlan;
+    class ThreadPool;
+
+    //! Evaluates an EvaluationPlan without barriers.
+    //! Each Node has an atomic count of unfinished producers and is pushed onto the queue of
+    //! the worker that finished its last producer. Each queue is a lock-free deque (Chase and Lev):
+    //! the owner pushes and pops at the bottom and idle workers steal from the top, so one slow
+    //! Node only delays the Nodes that depend on it. A worker that finds no queue with work sleeps
+    //! on a condition variable until a Node becomes ready or the frame ends.
+    //! With setCriticalPathFirst() the sources are dealt longest first and the Nodes made ready
+    //! together are pushed shortest first, so that each worker carries on along the longest
+    //! remaining chain, by EvaluationPlan::pathLength(), and thieves take the shorter ones.
+    class DAG_API DataflowExecutor
+    {
+    public:
+        DataflowExecutor() = default;
+
+        DataflowExecutor(const DataflowExecutor&) = delete;
+
+        DataflowExecutor& operator=(const DataflowExecutor&) = delete;
+
+        //! Choose whether ready Nodes are ordered by their remaining path length rather than last in, first out.
+        void setCriticalPathFirst(bool criticalPathFirst)
+        {
+            _criticalPathFirst = criticalPathFirst;
+        }
+
+        [[nodiscard]]bool isCriticalPathFirst() const
+        {
+            return _criticalPathFirst;
+        }
+
+        //! Evaluate every Node of plan using the threads of pool.
+        //! \pre plan.isValid()
+        void evaluate(const EvaluationPlan& plan, ThreadPool& pool);
+    private:
+        //! A fixed-capacity deque that is reset every frame, so it never wraps and never grows.
+        //! The owner pushes and pops at bottom, thieves take from top with a compare and swap.
+        struct alignas(64) WorkQueue
+        {
+            //! The next item for thieves, only ever increases within a frame
+            alignas(64) std::atomic<std::int64_t> top{0};
+            //! One past the last item, written by the owner only
+            alignas(64) std::atomic<std::int64_t> bottom{0};
+            std::unique_ptr<std::atomic<std::uint32_t>[]> items;
+            //! The Nodes made ready by the last Node of the owner
+            std::vector<std::uint32_t> ready;
+        };
+
+        void prepare(const EvaluationPlan& plan, std::size_t numWorkers);
+
+        void work(const EvaluationPlan& plan, std::size_t worker);
+
+        //! Find the next Node for worker, sleeping while no queue has one.
+        //! \retval false Every Node has run.
+        bool next(std::size_t worker, std::uint32_t& node);
+
+        //! Run node, then push the successors it made ready.
+        void run(const EvaluationPlan& plan, std::size_t worker, std::uint32_t node);
+
+        //! \pre Only called by the owner of the queue, or before the workers start.
+        void push(std::size_t worker, std::uint32_t node);
+
+        bool pop(std::size_t worker, std::uint32_t& node);
+
+        bool steal(std::size_t worker, std::uint32_t& node);
+
+        //! Wake sleeping workers after numReady Nodes were pushed that their owner will not run next.
+        void wake(std::size_t numReady);
+
+        //! Orders Nodes by path length.
+        bool shorter(std::uint32_t a, std::uint32_t b) const
+        {
+            return _pathLength[a] < _pathLength[b];
+        }
+
+        std::unique_ptr<std::atomic<std::uint32_t>[]> _counts;
+        std::vector<std::uint32_t> _sources;
+        std::size_t _numNodes{0};
+        std::unique_ptr<WorkQueue[]> _queues;
+        std::size_t _numWorkers{0};
+        std::atomic<std::size_t> _remaining{0};
+        std::mutex _idleMutex;
+        std::condition_variable _wakeUp;
+        std::atomic<std::uint32_t> _numSleeping{0};
+        //! Changed under _idleMutex whenever sleeping workers should look for work again
+        std::uint64_t _epoch{0};
+        //! The path lengths of the plan being evaluated, or nullptr when ready Nodes are last in, first out
+        const std::uint64_t* _pathLength{nullptr};
+        bool _criticalPathFirst{false};
+    };
+}
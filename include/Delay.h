@@ -0,0 +1,79 @@
+#pragma once
+
+#include "config/Export.h"
+
+#include "core/Node.h"
+#include "core/TypedPort.h"
+#include "core/KeyGenerator.h"
+#include "InlinePorts.h"
+
+#include <array>
+
+namespace dag
+{
+    //! A unit delay whose output is the value its input had at the end of the previous frame.
+    //! Connections into a Delay are feedback edges: sorting ignores them, so a cycle through
+    //! a Delay evaluates in one pass. The plan commits them after every Node has run, so the
+    //! input is the back buffer and the output the front buffer of the delayed value.
+    //! \note Cycles are only allowed through a Delay in Graphs without child Graphs.
+    class DAG_API Delay : public dagbase::Node
+    {
+    public:
+        Delay(dagbase::KeyGenerator& keyGen, const std::string& name, dagbase::NodeCategory::Category category)
+        :
+        Node(keyGen, name, category)
+        {
+            _input = _portStorage.emplace<0>(keyGen.nextPortID(), this, "input", dagbase::PortType::TYPE_DOUBLE, dagbase::PortDirection::DIR_IN, 0.0);
+            _output = _portStorage.emplace<1>(keyGen.nextPortID(), this, "output", dagbase::PortType::TYPE_DOUBLE, dagbase::PortDirection::DIR_OUT, 0.0);
+        }
+
+        Delay(dagbase::InputStream& str, dagbase::NodeLibrary& nodeLib, dagbase::Lua &lua);
+
+        Delay(const Delay& other, dagbase::CloningFacility& facility, dagbase::CopyOp copyOp, dagbase::KeyGenerator* keyGen);
+
+        ~Delay() override;
+
+        //! \return true if connections into node are feedback edges that do not order it after their source.
+        static bool isFeedback(const dagbase::Node* node)
+        {
+            return dynamic_cast<const Delay*>(node) != nullptr;
+        }
+
+        [[nodiscard]]bool equals(const Node& other, dagbase::ComparisonFlags flags) const override;
+
+        [[nodiscard]]const char* className() const override;
+
+        [[nodiscard]]const dagbase::MetaPort * dynamicMetaPort(size_t index) const override;
+
+        dagbase::MetaPort* dynamicMetaPort(size_t index) override;
+
+        dagbase::Port* dynamicPort(size_t index) override;
+
+        const dagbase::Port* dynamicPort(size_t index) const override;
+
+        Node* create(dagbase::InputStream& str, dagbase::NodeLibrary& nodeLib, dagbase::Lua &lua) override;
+
+        dagbase::OutputStream& writeToStream(dagbase::OutputStream& str, dagbase::NodeLibrary& nodeLib, dagbase::Lua &lua) const override;
+
+        Node* clone(dagbase::CloningFacility& facility, dagbase::CopyOp copyOp, dagbase::KeyGenerator* keyGen) override
+        {
+            return new Delay(*this, facility, copyOp, keyGen);
+        }
+
+        [[nodiscard]]size_t totalPorts() const override
+        {
+            return numPorts;
+        }
+
+        //! Publish the value committed to the input at the end of the previous frame.
+        void update() override;
+    protected:
+        static std::array<dagbase::MetaPort, 2> ports;
+        static constexpr size_t firstPort = 0;
+        static constexpr size_t numPorts = 2;
+    private:
+        InlinePorts<dagbase::TypedPort<double>, dagbase::TypedPort<double>> _portStorage;
+        dagbase::TypedPort<double>* _input{nullptr};
+        dagbase::TypedPort<double>* _output{nullptr};
+    };
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "config/Export.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace dag
+{
+    //! The Nodes of an EvaluationPlan waiting for EvaluationPlan::evaluateDirty().
+    //! A min-heap of Node indices, which is also their evaluation order because
+    //! successors always have a higher index than their producers.
+    class DAG_API DirtySet
+    {
+    public:
+        //! Size the set for n Nodes, all of which are dirty.
+        void reset(std::size_t n);
+
+        //! Add the Node at index.
+        //! \retval false The Node was already dirty.
+        bool mark(std::uint32_t index);
+
+        [[nodiscard]]bool empty() const
+        {
+            return _heap.empty();
+        }
+
+        //! Remove and return the dirty Node with the smallest index.
+        //! \pre !empty()
+        std::uint32_t pop();
+
+        //! Keep the Node at index for the next evaluation, for example because it is not due.
+        void defer(std::uint32_t index)
+        {
+            _deferred.emplace_back(index);
+        }
+
+        //! Mark every deferred Node again.
+        void restoreDeferred();
+
+        //! Mark every Node, for example after a full evaluation by another executor is skipped.
+        void markAll()
+        {
+            _all = true;
+        }
+
+        //! \return true if every Node is dirty, as after a compile.
+        [[nodiscard]]bool isAll() const
+        {
+            return _all;
+        }
+
+        //! Forget every dirty Node.
+        void clear();
+    private:
+        //! Per Node, 1 if it is in _heap
+        std::vector<std::uint8_t> _dirty;
+        //! A min-heap of the dirty Node indices
+        std::vector<std::uint32_t> _heap;
+        //! Dirty Nodes kept for a later evaluation
+        std::vector<std::uint32_t> _deferred;
+        bool _all{true};
+    };
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "config/Export.h"
+
+#include <cstdint>
+
+namespace dagbase
+{
+    class Port;
+}
+
+namespace dag
+{
+    //! Told when the value of a Port is set from outside evaluation, so that only the
+    //! Nodes downstream of the change need to be evaluated.
+    class DAG_API DirtyTracker
+    {
+    public:
+        virtual ~DirtyTracker() = default;
+
+        virtual void markDirty(const dagbase::Port& port) = 0;
+    };
+
+    //! Counts the changes to the value of a Port that owns its value, so that an EvaluationPlan can
+    //! see writes made directly to the Port without the Port knowing about the plan.
+    //! \note The Port calls changed() from every setter that alters its value.
+    class DAG_API ChangeCounter
+    {
+    public:
+        virtual ~ChangeCounter() = default;
+
+        //! \return The number of changes so far, compared with an earlier result to detect a change.
+        [[nodiscard]]std::uint64_t generation() const
+        {
+            return _generation;
+        }
+    protected:
+        void changed()
+        {
+            ++_generation;
+        }
+    private:
+        std::uint64_t _generation{0};
+    };
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "config/Export.h"
+
+#include "core/Variant.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace dag
+{
+    class EvaluationPlan;
+    class InstanceState;
+
+    //! Evaluates a plan a slice at a time, so that no call runs much longer than its budget.
+    //! Each call resumes at the Node after the last one run, and a frame ends when the last Node has run.
+    //! With a snapshot, the double and int64 Ports of the plan are copied at the end of each frame,
+    //! so readers of the snapshot never see a frame that is only partly evaluated.
+    //! \note Nodes run as in EvaluationPlan::runNode(), so folding, pruning, conditions, divisors
+    //! and fused chains apply but memoised GraphNodes do not.
+    class DAG_API EvaluationCursor
+    {
+    public:
+        EvaluationCursor() = default;
+
+        EvaluationCursor(const EvaluationCursor&) = delete;
+
+        EvaluationCursor& operator=(const EvaluationCursor&) = delete;
+
+        ~EvaluationCursor();
+
+        //! Run the Nodes of plan in order until the frame ends or budget has elapsed.
+        //! At least one Node runs per call, so every frame ends eventually.
+        //! A new compile of plan restarts the frame.
+        //! \pre plan.isValid()
+        //! \retval true The frame ended, the next call starts another one.
+        bool evaluate(const EvaluationPlan& plan, std::chrono::nanoseconds budget);
+
+        //! Start the next call at the first Node, abandoning the current frame.
+        void restart()
+        {
+            _next = 0;
+        }
+
+        //! \return true if a frame has started but not ended.
+        [[nodiscard]]bool isMidFrame() const
+        {
+            return _next != 0;
+        }
+
+        //! Choose whether to copy the Ports of the plan at the end of each frame.
+        void setSnapshot(bool snapshot);
+
+        //! \return The values at the end of the last frame, or nullptr before one ends or without a snapshot.
+        //! Each value is instance zero of the InstanceState.
+        [[nodiscard]]const InstanceState* snapshot() const
+        {
+            return _hasSnapshot ? _snapshot : nullptr;
+        }
+
+        dagbase::Variant find(std::string_view path) const;
+    private:
+        const EvaluationPlan* _plan{nullptr};
+        InstanceState* _snapshot{nullptr};
+        std::size_t _next{0};
+        std::uint32_t _compile{0};
+        std::uint32_t _numFrames{0};
+        std::uint32_t _numSlices{0};
+        bool _hasSnapshot{false};
+    };
+}
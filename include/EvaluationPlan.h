@@ -0,0 +1,570 @@
+#pragma once
+
+#include "config/Export.h"
+
+#include "BatchPlan.h"
+#include "ChainFusion.h"
+#include "ConeCache.h"
+#include "ConstantFolding.h"
+#include "DirtySet.h"
+#include "DirtyTracker.h"
+#include "Gating.h"
+#include "Liveness.h"
+#include "Memoisation.h"
+#include "RateSchedule.h"
+#include "core/Types.h"
+#include "core/Variant.h"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace dagbase
+{
+    class Graph;
+    class Node;
+    class Port;
+
+    template<typename T>
+    class TypedPort;
+}
+
+namespace dag
+{
+    class BatchContext;
+    class EvaluationProfile;
+    class InstanceState;
+    class ThreadPool;
+    class TopologicalOrder;
+
+    //! A copy of a value from an output Port to a connected input Port.
+    //! The copy function is selected once when the plan is compiled so that
+    //! evaluation does not need to inspect Port types.
+    struct DAG_API PortTransfer
+    {
+        using CopyFunc = void (*)(dagbase::Port* source, dagbase::Port* dest);
+        using EqualFunc = bool (*)(const dagbase::Port* source, const dagbase::Port* dest);
+
+        dagbase::Port* source{nullptr};
+        dagbase::Port* dest{nullptr};
+        CopyFunc copy{nullptr};
+        EqualFunc equal{nullptr};
+
+        void makeItSo() const
+        {
+            copy(source, dest);
+        }
+
+        //! \return true if dest already holds the value of source, so the transfer would change nothing.
+        [[nodiscard]]bool isCurrent() const
+        {
+            return equal(source, dest);
+        }
+
+        //! \return The fastest copy function that is valid for the given pair of Ports.
+        //! \note Converts int64 to double, bool to int64 and bool to double directly between TypedPorts,
+        //! and falls back to copying via dagbase::Value for any other pair that is not both TypedPorts of the same type.
+        static CopyFunc selectCopy(const dagbase::Port& source, const dagbase::Port& dest);
+
+        //! \return A comparison for the given pair of Ports.
+        //! \note Ports that are not both TypedPorts of the same type or of a converted pair always compare unequal.
+        static EqualFunc selectEqual(const dagbase::Port& source, const dagbase::Port& dest);
+    };
+
+    //! A compiled evaluation order for a Graph and all of its children.
+    //! Stores the sorted Nodes and the transfers into each Node as flat arrays
+    //! so that repeated evaluation of an unchanged topology does no sorting and no allocation.
+    //! Each optional feature, such as folding, gating or memoisation, is a component that owns its own
+    //! per-Node state and is compiled from the arrays of the plan.
+    //! Nodes are grouped by level, the length of the longest path from a Node with no producers,
+    //! so that the Nodes within a level are independent and can be evaluated concurrently.
+    class DAG_API EvaluationPlan : public DirtyTracker
+    {
+    public:
+        using NodeArray = std::vector<dagbase::Node*>;
+        using TransferArray = std::vector<PortTransfer>;
+        using IndexArray = std::vector<std::uint32_t>;
+
+        //! The producer of a transfer whose source Port is not owned by a Node in the plan.
+        static constexpr std::uint32_t NO_NODE = ~std::uint32_t{0};
+
+        //! How NodeEditorLive shares the plan between threads.
+        enum Scheduler : std::uint32_t
+        {
+            //! A barrier between levels, see evaluateParallel()
+            SCHEDULER_LEVELS,
+            //! Each Node runs as soon as its producers finish, see DataflowExecutor
+            SCHEDULER_DATAFLOW,
+            //! As SCHEDULER_DATAFLOW, but each worker carries on with the ready Node on the longest path to a sink, see pathLength()
+            SCHEDULER_CRITICAL_PATH
+        };
+    public:
+        EvaluationPlan() = default;
+
+        EvaluationPlan(const EvaluationPlan&) = delete;
+
+        EvaluationPlan& operator=(const EvaluationPlan&) = delete;
+
+        //! Sort the Graph and record the transfers into each Node.
+        //! \param topology An order maintained while editing, used instead of sorting the Graph when it is valid.
+        //! \retval STATUS_OK The plan is valid.
+        //! \retval STATUS_CYCLE_DETECTED The Graph cannot be sorted, the plan remains invalid.
+        dagbase::Status compile(dagbase::Graph& graph, const TopologicalOrder* topology = nullptr);
+
+        //! Choose whether compile() collapses Boundary pass-throughs into direct transfers.
+        //! \note When flattened the Ports of Boundary Nodes are not updated by evaluation,
+        //! except through evaluateFor().
+        void setFlattenBoundaries(bool flatten)
+        {
+            _flattenBoundaries = flatten;
+            _valid = false;
+        }
+
+        //! Choose whether compile() folds constant Nodes.
+        //! A Node is constant when it is not a source and every input is unconnected or fed by
+        //! constant Nodes. Constant Nodes are updated once and then skipped until markDirty() on
+        //! one of their Ports, which updates that Node and the constant Nodes downstream of it once more,
+        //! or the next compile.
+        //! \note Values written directly to Ports of constant Nodes are not seen, use markDirty().
+        void setFoldConstants(bool fold)
+        {
+            _folding.setEnabled(fold);
+            _valid = false;
+        }
+
+        //! Choose whether compile() fuses chains of MathsNode into one kernel.
+        //! A chain is a run of MathsNode each fed only by the output of the one before. The kernel keeps
+        //! the value in a register from link to link and writes every Port of the chain directly, so the
+        //! Ports read the same as without fusion but there is no update() or transfer per link.
+        //! The head of a chain runs the kernel in place of its update(), in every way of evaluating a frame.
+        //! \note Only Nodes that are live, not folded, not gated, without a divisor and on the same side of
+        //! every memoised Boundary are fused. evaluateFor(), evaluateBatch() and evaluateInstances() update
+        //! each link as usual.
+        void setFuseChains(bool fuse)
+        {
+            _fusion.setEnabled(fuse);
+            _valid = false;
+        }
+
+        //! Choose whether prepareBatch() lets an input read the array of the output connected to it
+        //! when both have the same type, so that evaluateBatch() copies samples only where a
+        //! conversion is needed.
+        //! \note On by default. Takes effect at the next prepareBatch().
+        void setZeroCopy(bool zeroCopy)
+        {
+            _batch.setZeroCopy(zeroCopy);
+        }
+
+        //! Choose whether evaluation skips dead Nodes, those that cannot reach a CAT_SINK Node or a pinned Port.
+        //! \note With no sinks and no pins every Node is dead.
+        void setPruneDeadNodes(bool prune)
+        {
+            _liveness.setPruning(prune);
+            _valid = false;
+        }
+
+        //! Cache the outputs of the child Graph of a GraphNode against the values of its inputs,
+        //! so that evaluate() restores them instead of evaluating the child Graph again.
+        //! \param capacity The number of input values remembered, zero to stop caching.
+        //! \note The child Graph must be pure. Its Boundaries are not flattened and a cached
+        //! GraphNode inside another one is evaluated normally. Only evaluate() uses the cache.
+        void setMemoise(dagbase::NodeID graphNode, std::size_t capacity);
+
+        //! Run the Node with the given id only on every divisor-th frame.
+        //! The outputs of a Node that is not due keep their last values, so a faster consumer
+        //! samples and holds them and a slower consumer reads the latest value of a faster producer.
+        //! \param divisor One or zero to run the Node on every frame.
+        //! \note Divisors survive compiles, they refer to Nodes by id. Every way of evaluating a whole
+        //! frame honours them, evaluateDirty() keeps a dirty Node that is not due for a later frame.
+        void setDivisor(dagbase::NodeID id, std::uint32_t divisor);
+
+        //! \return The number of frames evaluated so far, which decides the Nodes that are due.
+        [[nodiscard]]std::uint64_t tick() const
+        {
+            return _schedule.tick();
+        }
+
+        //! Keep the Node that produces the value of the Port with the given id alive.
+        //! \note Pins survive compiles, they refer to Ports by id.
+        void pin(dagbase::PortID id);
+
+        void unpin(dagbase::PortID id);
+
+        //! \return true if the Node at index is evaluated, which is every Node unless pruning.
+        [[nodiscard]]bool isLive(std::size_t index) const
+        {
+            return _liveness.isLive(index);
+        }
+
+        //! Force a compile before the next evaluation, typically because the topology changed.
+        void invalidate()
+        {
+            _valid = false;
+        }
+
+        [[nodiscard]]bool isValid() const
+        {
+            return _valid;
+        }
+
+        //! Run the incoming transfers then update() for each Node in order.
+        //! A CAT_CONDITION Node whose gate is false after its update() closes the Nodes downstream of it
+        //! for the frame, and those Nodes keep their previous outputs. The gate is the first bool output
+        //! of the condition, in which case only the consumers of that output are gated, or failing that
+        //! its first bool input, in which case every output is. A Node is skipped only when every one
+        //! of its inputs is closed, so a Node that joins a gated branch to an ungated one still runs.
+        //! \pre isValid()
+        void evaluate();
+
+        //! As evaluate() but record the time taken by every update() and transfer in profile.
+        //! \note profile is reset when it was last used with a different compile. The frame is
+        //! the same as that of evaluate(), a fused chain is timed as the update() of its head.
+        void evaluate(EvaluationProfile& profile);
+
+        //! Mark the Node that owns port for the next evaluateDirty().
+        //! \note Ignored while the plan is invalid because the next compile marks every Node.
+        void markDirty(const dagbase::Port& port) override;
+
+        //! Mark every Node, for example after a full evaluation by another executor is skipped.
+        void markAllDirty()
+        {
+            _dirty.markAll();
+        }
+
+        //! Forget pending dirty Nodes, typically after every Node was evaluated.
+        void clearDirty();
+
+        //! Evaluate only the dirty Nodes and the Nodes downstream of them, in order.
+        //! Propagation stops at a Node when none of its outputs changed.
+        //! \pre isValid()
+        //! Values written directly to a Port that counts its changes, such as a PrimitivePort, mark the
+        //! Port as if markDirty() had been called.
+        //! \note Other direct writes are not seen, use markDirty().
+        void evaluateDirty();
+
+        //! Evaluate only the Node that owns port and the Nodes upstream of it.
+        //! The upstream cone is cached per Port until the next compile.
+        //! \note Conditions do not gate the cone, port was asked for explicitly.
+        //! \pre isValid()
+        //! \retval false port is not owned by a Node in the plan.
+        bool evaluateFor(dagbase::Port& port);
+
+        //! Give every double and int64 Port in the plan an array of n samples in context,
+        //! filled with the current value of the Port.
+        //! \pre isValid()
+        //! \note context must outlive the plan or the next prepareBatch().
+        void prepareBatch(BatchContext& context, std::size_t n);
+
+        //! \return true if evaluateBatch() may be called, false after a compile.
+        [[nodiscard]]bool isBatchPrepared() const
+        {
+            return _batch.isPrepared();
+        }
+
+        //! Evaluate every sample of the prepared batch.
+        //! Nodes that implement BatchNode update all samples at once, other Nodes run update()
+        //! once per sample with their Ports loaded from and stored to the arrays.
+        //! \pre isBatchPrepared()
+        void evaluateBatch();
+
+        //! Give each of n instances a block in state, filled with the current values of the Ports.
+        //! \pre isValid()
+        //! \note state must outlive the plan or the next prepareInstances().
+        //! \retval false A Port has a type that cannot be held per instance, see InstanceState::reset().
+        bool prepareInstances(InstanceState& state, std::size_t n);
+
+        //! \return true if evaluateInstances() may be called, false after a compile.
+        [[nodiscard]]bool isInstancesPrepared() const
+        {
+            return _instanceState != nullptr;
+        }
+
+        //! Evaluate every instance in turn against its block. The transfers copy values within the block,
+        //! and each Node that runs has its Ports loaded from the block before update() and its outputs
+        //! stored back after, so a Node skipped by a condition keeps the outputs of that instance.
+        //! \note Folding, fusion and memoisation are ignored because instances differ in their inputs.
+        //! \pre isInstancesPrepared()
+        void evaluateInstances();
+
+        //! Evaluate one level at a time, sharing the Nodes of each level between the threads of pool.
+        //! The results are identical to evaluate() because no Node reads a Port written in its own level.
+        //! \pre isValid()
+        //! \note update() must only write to Ports of its own Node.
+        void evaluateParallel(ThreadPool& pool);
+
+        [[nodiscard]]std::size_t numNodes() const
+        {
+            return _nodes.size();
+        }
+
+        [[nodiscard]]std::size_t numTransfers() const
+        {
+            return _transfers.size();
+        }
+
+        //! \return The transfer at index, transfers into each Node are contiguous and in Node order.
+        [[nodiscard]]const PortTransfer& transfer(std::size_t index) const
+        {
+            return _transfers[index];
+        }
+
+        //! \return The incoming transfers of the Node at index are [beginTransfer(index), endTransfer(index)).
+        [[nodiscard]]std::uint32_t beginTransfer(std::size_t index) const
+        {
+            return _firstTransfer[index];
+        }
+
+        [[nodiscard]]std::uint32_t endTransfer(std::size_t index) const
+        {
+            return _firstTransfer[index + 1];
+        }
+
+        //! \return The index of the Node that owns the source Port of transfer t, or NO_NODE.
+        [[nodiscard]]std::uint32_t sourceNode(std::size_t t) const
+        {
+            return _sourceNode[t];
+        }
+
+        //! \return The index of the Node whose incoming range holds transfer t.
+        [[nodiscard]]std::uint32_t destNode(std::size_t t) const
+        {
+            return _destNode[t];
+        }
+
+        //! \return Every transfer out of the Node at index is in [beginOutgoing(index), endOutgoing(index))
+        [[nodiscard]]const std::uint32_t* beginOutgoing(std::size_t index) const
+        {
+            return _outgoing.data() + _firstOutgoing[index];
+        }
+
+        [[nodiscard]]const std::uint32_t* endOutgoing(std::size_t index) const
+        {
+            return _outgoing.data() + _firstOutgoing[index + 1];
+        }
+
+        //! \return The index of the Node that owns port, or NO_NODE if no Node in the plan does.
+        [[nodiscard]]std::uint32_t nodeOf(const dagbase::Port* port) const
+        {
+            auto it = _portNode.find(port);
+
+            return it != _portNode.end() ? it->second : NO_NODE;
+        }
+
+        //! \return The number of transfers into Delay Nodes, run after every other Node.
+        [[nodiscard]]std::size_t numFeedback() const
+        {
+            return _feedback.size();
+        }
+
+        [[nodiscard]]const PortTransfer& feedbackTransfer(std::size_t f) const
+        {
+            return _feedback[f];
+        }
+
+        //! \return The Node that produces the value of feedback transfer f, or NO_NODE.
+        [[nodiscard]]std::uint32_t feedbackSource(std::size_t f) const
+        {
+            return _feedbackSource[f];
+        }
+
+        //! \return The Delay written by feedback transfer f.
+        [[nodiscard]]std::uint32_t feedbackDest(std::size_t f) const
+        {
+            return _feedbackDest[f];
+        }
+
+        //! \return Boundary outputs to their partner inputs, and connected Boundary inputs to their source.
+        [[nodiscard]]const std::unordered_map<const dagbase::Port*, dagbase::Port*>& boundaryIndirection() const
+        {
+            return _boundaryIndirection;
+        }
+
+        //! Follow Boundary pass-throughs and GraphNode inputs back to the Port that holds the value.
+        [[nodiscard]]dagbase::Port* resolve(dagbase::Port* port) const;
+
+        //! \return The number of successful compiles, which identifies the current one.
+        [[nodiscard]]std::uint32_t numCompiles() const
+        {
+            return _numCompiles;
+        }
+
+        [[nodiscard]]std::size_t numLevels() const
+        {
+            return _firstNodeOfLevel.empty() ? 0 : _firstNodeOfLevel.size() - 1;
+        }
+
+        [[nodiscard]]dagbase::Node* node(std::size_t index) const
+        {
+            return index < _nodes.size() ? _nodes[index] : nullptr;
+        }
+
+        //! \return The number of distinct Nodes in the plan that feed the given Node.
+        [[nodiscard]]std::uint32_t numPredecessors(std::size_t index) const
+        {
+            return _numPredecessors[index];
+        }
+
+        //! \return The distinct Nodes fed by the given Node are [beginSuccessors(index), endSuccessors(index))
+        [[nodiscard]]const std::uint32_t* beginSuccessors(std::size_t index) const
+        {
+            return _successors.data() + _firstSuccessor[index];
+        }
+
+        [[nodiscard]]const std::uint32_t* endSuccessors(std::size_t index) const
+        {
+            return _successors.data() + _firstSuccessor[index + 1];
+        }
+
+        //! \return The cost of the Node at index plus that of its most expensive chain of successors.
+        [[nodiscard]]std::uint64_t pathLength(std::size_t index) const
+        {
+            return _pathLength[index];
+        }
+
+        //! \return The pathLength() of every Node, in plan order.
+        [[nodiscard]]const std::uint64_t* pathLengths() const
+        {
+            return _pathLength.data();
+        }
+
+        //! Compute pathLength() for every Node.
+        //! \param profile The mean time of update() and of the transfers into each Node, found by NodeID and PortID
+        //! so that the timings of a previous compile still apply. When nullptr, or for Nodes with no timings,
+        //! every Node costs one.
+        //! \note compile() weighs every Node as one.
+        void weighCriticalPath(const EvaluationProfile* profile);
+
+        //! Copy the values fed back into every Delay, ready for the next frame.
+        //! \note Every evaluation of a whole frame ends with this, including DataflowExecutor.
+        void commitFeedback() const;
+
+        //! Decide the Nodes that are due this frame, see setDivisor().
+        //! \note Every evaluation of a whole frame starts with this, including DataflowExecutor.
+        void beginFrame() const;
+
+        //! Advance the tick, the only place it changes.
+        //! \note Every evaluation of a whole frame ends with this, after commitFeedback().
+        void endFrame() const
+        {
+            _schedule.endFrame();
+        }
+
+        //! Run one Node in push order: the transfers that no producer pushes, update(), then
+        //! the transfers out of the Node into its successors. Like evaluate() it skips a Node
+        //! that is folded, dead, gated off or not due.
+        //! \note Safe to call concurrently for Nodes whose predecessors have all finished.
+        void runNode(std::size_t index) const;
+
+        dagbase::Variant find(std::string_view path) const;
+    private:
+        template<typename Instrumentation>
+        void evaluateFrame(Instrumentation& instrumentation);
+
+        //! Evaluate the Node at index as part of a whole frame, looking up or filling the cache of a memo.
+        template<typename Instrumentation>
+        void evaluateStep(std::size_t index, Instrumentation& instrumentation);
+
+        template<typename Instrumentation>
+        void evaluateNode(std::size_t index, Instrumentation& instrumentation) const;
+
+        void evaluateNode(std::size_t index) const;
+
+        void buildAdjacency();
+
+        void markNodeDirty(std::uint32_t index);
+
+        //! Find the Ports of the plan and the sources of its transfers that count their changes.
+        void watchPorts();
+
+        //! Mark every watched Port whose value changed since the last call.
+        void collectChanges();
+
+        void updateNode(std::size_t index) const;
+
+        template<typename Instrumentation>
+        void updateNode(std::size_t index, Instrumentation& instrumentation) const;
+
+        //! \return true if the Node at index does not run this frame, whatever its inputs.
+        [[nodiscard]]bool isSkipped(std::size_t index) const
+        {
+            // A fused link was run by the head of its chain.
+            return _fusion.isFused(index) || !_liveness.isLive(index) || _folding.isCurrent(index) || !_schedule.isDue(index);
+        }
+
+        //! Record that the Node at index ran, in every component that tracks it.
+        //! \note Safe to call concurrently for different Nodes.
+        void nodeUpdated(std::size_t index) const
+        {
+            _folding.markUpdated(*this, index);
+            _gating.updateGate(index);
+        }
+
+        //! Run the transfers into the head of a chain, then the kernel of the chain.
+        template<typename Instrumentation>
+        void evaluateChain(std::uint32_t chain, Instrumentation& instrumentation) const;
+
+        //! Find the Nodes that fusion may link, see setFuseChains().
+        void fuseChains();
+
+        NodeArray _nodes;
+        TransferArray _transfers;
+        //! The incoming transfers of _nodes[i] are [_firstTransfer[i], _firstTransfer[i+1])
+        IndexArray _firstTransfer;
+        //! The index in _nodes of the Node that owns the source Port of each transfer, or NO_NODE
+        IndexArray _sourceNode;
+        //! The Nodes of level l are [_firstNodeOfLevel[l], _firstNodeOfLevel[l+1])
+        IndexArray _firstNodeOfLevel;
+        IndexArray _numPredecessors;
+        std::vector<std::uint64_t> _pathLength;
+        //! The successors of _nodes[i] are [_firstSuccessor[i], _firstSuccessor[i+1]) in _successors
+        IndexArray _firstSuccessor;
+        IndexArray _successors;
+        //! Transfers run by their producer after update(), indexed like _successors
+        IndexArray _firstPushed;
+        IndexArray _pushed;
+        //! Transfers run by their consumer before update(), because they have no producer in the
+        //! plan or share a destination Port with another transfer and must keep their order.
+        IndexArray _firstPulled;
+        IndexArray _pulled;
+        //! The index in _nodes of the Node whose incoming range holds each transfer
+        IndexArray _destNode;
+        //! Every transfer out of _nodes[i] is [_firstOutgoing[i], _firstOutgoing[i+1]) in _outgoing
+        IndexArray _firstOutgoing;
+        IndexArray _outgoing;
+        std::unordered_map<const dagbase::Port*, std::uint32_t> _portNode;
+        //! A Port that counts its changes and the count last seen, see collectChanges()
+        struct WatchedPort
+        {
+            const dagbase::Port* port{nullptr};
+            const ChangeCounter* counter{nullptr};
+            std::uint64_t generation{0};
+        };
+        std::vector<WatchedPort> _watched;
+        //! The transfers into Delay Nodes, run after every other Node
+        TransferArray _feedback;
+        //! Per feedback transfer, the Node that produces its value or NO_NODE
+        IndexArray _feedbackSource;
+        //! Per feedback transfer, the Delay it writes
+        IndexArray _feedbackDest;
+        //! Boundary outputs to their partner inputs, and connected Boundary inputs to their source
+        std::unordered_map<const dagbase::Port*, dagbase::Port*> _boundaryIndirection;
+        std::uint32_t _numFlattened{0};
+        bool _flattenBoundaries{true};
+        DirtySet _dirty;
+        std::uint32_t _numUpdated{0};
+        ConeCache _cones;
+        ConstantFolding _folding;
+        Liveness _liveness;
+        Gating _gating;
+        Memoisation _memoisation;
+        mutable RateSchedule _schedule;
+        ChainFusion _fusion;
+        BatchPlan _batch;
+        InstanceState* _instanceState{nullptr};
+        std::uint32_t _numCompiles{0};
+        bool _valid{false};
+    };
+}
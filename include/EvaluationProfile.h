@@ -0,0 +1,160 @@
+#pragma once
+
+#include "config/Export.h"
+
+#include "core/Types.h"
+#include "core/Variant.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace dag
+{
+    class EvaluationPlan;
+
+    //! Timings of one Node update() or one transfer makeItSo().
+    struct DAG_API EvaluationStats
+    {
+        std::uint64_t count{0};
+        std::uint64_t totalNanos{0};
+        std::uint64_t minNanos{std::numeric_limits<std::uint64_t>::max()};
+        std::uint64_t maxNanos{0};
+        std::uint64_t lastNanos{0};
+
+        void record(std::uint64_t nanos)
+        {
+            ++count;
+            totalNanos += nanos;
+            minNanos = nanos < minNanos ? nanos : minNanos;
+            maxNanos = nanos > maxNanos ? nanos : maxNanos;
+            lastNanos = nanos;
+        }
+
+        dagbase::Variant find(std::string_view path) const;
+    };
+
+    //! Timings of every Node and transfer of an EvaluationPlan, filled in by EvaluationPlan::evaluate(EvaluationProfile&).
+    //! Nodes are found by NodeID, e.g. nodes[5].totalNanos, and transfers by the PortID they write, e.g. transfers[7].lastNanos.
+    class DAG_API EvaluationProfile
+    {
+    public:
+        struct HotSpot
+        {
+            std::string name;
+            EvaluationStats stats;
+        };
+
+        typedef std::vector<HotSpot> HotSpotArray;
+    public:
+        EvaluationProfile() = default;
+
+        //! Size the profile for plan and clear every timing.
+        void reset(const EvaluationPlan& plan);
+
+        //! \return true if the profile was reset for the current compile of plan.
+        [[nodiscard]]bool matches(const EvaluationPlan& plan) const;
+
+        EvaluationStats& nodeStats(std::size_t index)
+        {
+            return _nodeStats[index];
+        }
+
+        EvaluationStats& transferStats(std::size_t index)
+        {
+            return _transferStats[index];
+        }
+
+        //! \return The mean time of update() for the Node with id, or zero if it has no timings.
+        [[nodiscard]]std::uint64_t meanNodeNanos(dagbase::NodeID id) const;
+
+        //! \return The mean time of the transfer that writes the Port with id, or zero if it has no timings.
+        [[nodiscard]]std::uint64_t meanTransferNanos(dagbase::PortID id) const;
+
+        //! \return Up to count Nodes and transfers in decreasing order of total time.
+        HotSpotArray hotList(std::size_t count) const;
+
+        //! Write hotList(count) one entry per line.
+        void writeHotList(std::ostream& str, std::size_t count) const;
+
+        dagbase::Variant find(std::string_view path) const;
+    private:
+        std::vector<EvaluationStats> _nodeStats;
+        std::vector<EvaluationStats> _transferStats;
+        std::vector<dagbase::NodeID> _nodeIds;
+        std::vector<dagbase::PortID> _transferIds;
+        std::vector<std::string> _nodeNames;
+        std::vector<std::string> _transferNames;
+        //! From the value of a NodeID or PortID to its index in the stats
+        std::unordered_map<std::uint32_t, std::size_t> _nodeIndex;
+        std::unordered_map<std::uint32_t, std::size_t> _transferIndex;
+        const EvaluationPlan* _plan{nullptr};
+        std::uint32_t _compile{0};
+    };
+
+    //! The instrumentation used by plain evaluation, every call compiles to nothing.
+    struct NoInstrumentation
+    {
+        void beginNode(std::size_t)
+        {
+        }
+
+        void endNode(std::size_t)
+        {
+        }
+
+        void beginTransfer(std::size_t)
+        {
+        }
+
+        void endTransfer(std::size_t)
+        {
+        }
+    };
+
+    //! Records the duration of every update() and makeItSo() in an EvaluationProfile.
+    class TimingInstrumentation
+    {
+    public:
+        explicit TimingInstrumentation(EvaluationProfile& profile)
+        :
+        _profile(profile)
+        {
+            // Do nothing.
+        }
+
+        void beginNode(std::size_t)
+        {
+            _start = std::chrono::steady_clock::now();
+        }
+
+        void endNode(std::size_t index)
+        {
+            _profile.nodeStats(index).record(elapsed());
+        }
+
+        void beginTransfer(std::size_t)
+        {
+            _start = std::chrono::steady_clock::now();
+        }
+
+        void endTransfer(std::size_t index)
+        {
+            _profile.transferStats(index).record(elapsed());
+        }
+    private:
+        std::uint64_t elapsed() const
+        {
+            return std::uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - _start).count());
+        }
+
+        EvaluationProfile& _profile;
+        std::chrono::steady_clock::time_point _start;
+    };
+}
@@ -0,0 +1,151 @@
+#pragma once
+
+#include "config/Export.h"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace dag
+{
+    //! Polynomial sin and cos, written without branches so that loops over arrays vectorise.
+    //! The argument is reduced to [-pi/4, pi/4] by the nearest multiple of pi/2, which is
+    //! accurate up to reductionLimit, beyond which the array functions use std::sin and std::cos.
+    //! \note src/FastMath.cpp is built with -O3 so that the array functions are vectorised,
+    //! and with -march=native as well when DAG_NATIVE_ARCH is on.
+    class DAG_API FastMath
+    {
+    public:
+        enum Accuracy : std::uint32_t
+        {
+            //! std::sin and std::cos
+            ACCURACY_EXACT,
+            //! Within one unit in the last place
+            ACCURACY_ULP,
+            //! Absolute error below 1e-6
+            ACCURACY_FAST
+        };
+
+        static constexpr double reductionLimit = 1.0e6;
+    public:
+        //! y[i] = sin(x[i] * scale) for i in [0, n)
+        static void sin(const double* x, double* y, std::size_t n, double scale, Accuracy accuracy);
+
+        //! y[i] = cos(x[i] * scale) for i in [0, n)
+        static void cos(const double* x, double* y, std::size_t n, double scale, Accuracy accuracy);
+
+        static double sin(double x, Accuracy accuracy)
+        {
+            if (accuracy == ACCURACY_EXACT || !(std::abs(x) <= reductionLimit))
+            {
+                return std::sin(x);
+            }
+
+            return accuracy == ACCURACY_ULP ? kernel<ACCURACY_ULP>(x, 0) : kernel<ACCURACY_FAST>(x, 0);
+        }
+
+        static double cos(double x, Accuracy accuracy)
+        {
+            if (accuracy == ACCURACY_EXACT || !(std::abs(x) <= reductionLimit))
+            {
+                return std::cos(x);
+            }
+
+            return accuracy == ACCURACY_ULP ? kernel<ACCURACY_ULP>(x, 1) : kernel<ACCURACY_FAST>(x, 1);
+        }
+
+        //! sin(x + quadrant * pi/2) for |x| <= reductionLimit, cos being quadrant one.
+        template<Accuracy accuracy>
+        static double kernel(double x, std::uint64_t quadrant)
+        {
+            // Adding 1.5 * 2^52 rounds to the nearest integer, which is then in the low bits.
+            constexpr double shifter = 6755399441055744.0;
+            constexpr double twoOverPi = 6.36619772367581382433e-01;
+            // pi/2 in two parts, the first with few enough bits that k * pio2Hi is exact.
+            constexpr double pio2Hi = 1.57079632673412561417e+00;
+            constexpr double pio2Lo = 6.07710050650619224932e-11;
+
+            const double shifted = x * twoOverPi + shifter;
+            const double k = shifted - shifter;
+            std::uint64_t bits;
+            std::memcpy(&bits, &shifted, sizeof(bits));
+            const std::uint64_t q = bits + quadrant;
+
+            double s;
+            double c;
+            if constexpr (accuracy == ACCURACY_ULP)
+            {
+                // pi/2 in four parts, the first three with few enough bits that k times each is exact.
+                constexpr double pio2Mid = 6.07710050630396597660e-11;
+                constexpr double pio2Low = 2.02226624871116645580e-21;
+                constexpr double pio2Tail = 8.47842766036889956997e-32;
+
+                // Keep the rounding errors of the reduction as the tail y of r = y0 + y1.
+                double error2;
+                double error3;
+                const double r2 = twoDiff(x - k * pio2Hi, k * pio2Mid, error2);
+                const double r3 = twoDiff(r2, k * pio2Low, error3);
+                const double tail = (error2 + error3) - k * pio2Tail;
+                const double y0 = r3 + tail;
+                const double y1 = (r3 - y0) + tail;
+                const double z = y0 * y0;
+                const double v = z * y0;
+
+                // The minimax kernels of fdlibm, which use the tail to stay within one unit in the last place.
+                s = y0 - ((z * (0.5 * y1 - v * (8.33333333332248946124e-03 + z * (-1.98412698298579493134e-04 +
+                    z * (2.75573137070700676789e-06 + z * (-2.50507602534068634195e-08 + z * 1.58969099521155010221e-10))))) -
+                    y1) - v * -1.66666666666666324348e-01);
+                const double w = z * z * (4.16666666666666019037e-02 + z * (-1.38888888888741095749e-03 +
+                    z * (2.48015872894767294178e-05 + z * (-2.75573143513906633035e-07 +
+                    z * (2.08757232129817482790e-09 + z * -1.13596475577881948265e-11)))));
+
+                // Subtract 0.5z in two steps when it is large, through qx: zero below 0.3, 0.28125 above
+                // 0.78125 and otherwise a quarter of |y0| cut to 21 bits. The tests are done on the bits.
+                std::uint64_t yBits;
+                std::memcpy(&yBits, &y0, sizeof(yBits));
+                const std::uint64_t absBits = yBits & ~(std::uint64_t{1} << 63);
+                const std::uint64_t small = std::uint64_t{0} - ((absBits - 0x3FD3333300000000) >> 63);
+                const std::uint64_t large = std::uint64_t{0} - ((0x3FE9000000000000 - absBits) >> 63);
+                const std::uint64_t quarterBits = (absBits - (std::uint64_t{2} << 52)) & 0xFFFFFFFF00000000;
+                const std::uint64_t qxBits = (quarterBits & ~small & ~large) | (0x3FD2000000000000 & large);
+                double qx;
+                std::memcpy(&qx, &qxBits, sizeof(qx));
+                c = (1.0 - qx) - ((0.5 * z - qx) - (w - y0 * y1));
+            }
+            else
+            {
+                const double r = (x - k * pio2Hi) - k * pio2Lo;
+                const double r2 = r * r;
+
+                s = r + r * r2 * (-1.66666666666666666667e-01 + r2 * (8.33333333333333333333e-03 +
+                    r2 * -1.98412698412698412698e-04));
+                c = 1.0 - 0.5 * r2 + r2 * r2 * (4.16666666666666666667e-02 + r2 * (-1.38888888888888888889e-03 +
+                    r2 * 2.48015873015873015873e-05));
+            }
+
+            // Select and negate through the bits, a ternary here keeps the loops scalar.
+            std::uint64_t sBits;
+            std::uint64_t cBits;
+            std::memcpy(&sBits, &s, sizeof(sBits));
+            std::memcpy(&cBits, &c, sizeof(cBits));
+            const std::uint64_t odd = std::uint64_t{0} - (q & 1);
+            const std::uint64_t valueBits = ((cBits & odd) | (sBits & ~odd)) ^ ((q & 2) << 62);
+            double value;
+            std::memcpy(&value, &valueBits, sizeof(value));
+
+            return value;
+        }
+    private:
+        //! \return a - b rounded, with the rounding error in error.
+        static double twoDiff(double a, double b, double& error)
+        {
+            const double difference = a - b;
+            const double bPart = difference - a;
+
+            error = (a - (difference - bPart)) - (b + bPart);
+
+            return difference;
+        }
+    };
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "config/Export.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace dagbase
+{
+    template<typename T>
+    class TypedPort;
+}
+
+namespace dag
+{
+    class EvaluationPlan;
+
+    //! The CAT_CONDITION Nodes of an EvaluationPlan and the Nodes they switch off.
+    //! A condition whose gate is false after its update() closes the Nodes downstream of it for
+    //! the frame. The gate is the first bool output of the condition, in which case only the consumers
+    //! of that output are gated, or failing that its first bool input, in which case every output is.
+    //! A Node is skipped only when every one of its inputs is closed.
+    class DAG_API Gating
+    {
+    public:
+        //! Find the conditions of plan and the transfers each one closes.
+        void compile(const EvaluationPlan& plan);
+
+        //! \return true if the Node at index is downstream of a condition.
+        [[nodiscard]]bool isGated(std::size_t index) const
+        {
+            return !_gated.empty() && _gated[index] != 0;
+        }
+
+        //! Skip a Node behind a closed condition, otherwise clear its flag.
+        //! \retval true The Node must not run this frame.
+        bool gate(const EvaluationPlan& plan, std::size_t index) const;
+
+        //! Open or close the gate of a condition from its value, after the Node at index ran.
+        //! \note Safe to call concurrently for different Nodes.
+        void updateGate(std::size_t index) const;
+
+        //! \return The CLOSED_ bits of the Node at index this frame.
+        [[nodiscard]]std::uint8_t closed(std::size_t index) const
+        {
+            return _closed.empty() ? 0 : _closed[index];
+        }
+
+        [[nodiscard]]std::uint32_t numConditions() const
+        {
+            return _numConditions;
+        }
+
+        [[nodiscard]]std::uint32_t numGated() const
+        {
+            return _numGated;
+        }
+    private:
+        //! \return true if every transfer into the Node at index is closed.
+        bool isGatedOff(const EvaluationPlan& plan, std::size_t index) const;
+
+        enum : std::uint8_t
+        {
+            //! The Node was skipped this frame because every one of its inputs was closed
+            CLOSED_SKIPPED = 1,
+            //! The Node is a condition whose gate is false
+            CLOSED_GATE = 2
+        };
+        //! Per Node, the gate of a CAT_CONDITION Node, otherwise nullptr. Empty when there are no conditions.
+        std::vector<const dagbase::TypedPort<bool>*> _gate;
+        //! Per Node, 1 if it is downstream of a condition
+        std::vector<std::uint8_t> _gated;
+        //! Per Node, its CLOSED_ bits this frame
+        mutable std::vector<std::uint8_t> _closed;
+        //! Per transfer, the CLOSED_ bits of its source that close it, zero if it is not gated
+        std::vector<std::uint8_t> _gateMask;
+        std::uint32_t _numConditions{0};
+        std::uint32_t _numGated{0};
+    };
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "core/Port.h"
+
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <tuple>
+#include <utility>
+
+namespace dag
+{
+    //! Storage inside a Node for its built-in Ports, so that constructing or cloning the Node
+    //! allocates nothing per Port and the Ports sit next to the Node in memory.
+    //! \note A Node may still hold Ports that live elsewhere, such as those read from a stream,
+    //! so it frees every Port through release(), which deletes the Ports it does not hold.
+    template<typename... Ports>
+    class InlinePorts
+    {
+    public:
+        static constexpr std::size_t size = sizeof...(Ports);
+
+        template<std::size_t I>
+        using PortAt = std::tuple_element_t<I, std::tuple<Ports...>>;
+    public:
+        InlinePorts() = default;
+
+        InlinePorts(const InlinePorts&) = delete;
+
+        InlinePorts& operator=(const InlinePorts&) = delete;
+
+        ~InlinePorts()
+        {
+            for (std::size_t i=0; i<size; ++i)
+            {
+                destroy(i);
+            }
+        }
+
+        //! Construct the Port at I in place, destroying any Port already there.
+        //! \return The new Port.
+        template<std::size_t I, typename... Args>
+        PortAt<I>* emplace(Args&&... args)
+        {
+            destroy(I);
+            auto port = new (std::get<I>(_slots).bytes) PortAt<I>(std::forward<Args>(args)...);
+            _ports[I] = port;
+
+            return port;
+        }
+
+        //! \return true if port lies in our storage, so it must not be deleted.
+        [[nodiscard]]bool holds(const dagbase::Port* port) const
+        {
+            const std::less<const void*> before;
+
+            return port != nullptr && !before(port, this) && before(port, this + 1);
+        }
+
+        //! Destroy port in place if we hold it, otherwise delete it.
+        void release(dagbase::Port* port)
+        {
+            if (!holds(port))
+            {
+                delete port;
+
+                return;
+            }
+
+            for (std::size_t i=0; i<size; ++i)
+            {
+                if (_ports[i] == port)
+                {
+                    destroy(i);
+                }
+            }
+        }
+    private:
+        template<typename T>
+        struct Slot
+        {
+            alignas(T) unsigned char bytes[sizeof(T)];
+        };
+
+        void destroy(std::size_t index)
+        {
+            if (_ports[index] != nullptr)
+            {
+                _ports[index]->~Port();
+                _ports[index] = nullptr;
+            }
+        }
+
+        std::tuple<Slot<Ports>...> _slots;
+        std::array<dagbase::Port*, size> _ports{};
+    };
+}
@@ -0,0 +1,155 @@
+#pragma once
+
+#include "config/Export.h"
+
+#include "core/Types.h"
+#include "core/Value.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace dagbase
+{
+    class Port;
+
+    template<typename T>
+    class TypedPort;
+}
+
+namespace dag
+{
+    class EvaluationPlan;
+
+    //! The values of every Port of a plan for many instances of the same topology.
+    //! Each instance owns one contiguous block of values and the Nodes are shared,
+    //! so an instance costs a block rather than a deep clone of every Node, Port and transfer.
+    //! The state of a Delay lives in its Ports, so each instance has its own delayed values.
+    class DAG_API InstanceState
+    {
+    public:
+        static constexpr std::size_t alignment = 64;
+    public:
+        InstanceState() = default;
+
+        InstanceState(const InstanceState&) = delete;
+
+        InstanceState& operator=(const InstanceState&) = delete;
+
+        ~InstanceState();
+
+        //! Lay out a block for each of numInstances, each filled with the current values of the Ports of plan.
+        //! \retval false A Port is not a double, int64, bool or string, so it cannot be held per instance.
+        bool reset(const EvaluationPlan& plan, std::size_t numInstances);
+
+        [[nodiscard]]std::size_t numInstances() const
+        {
+            return _numInstances;
+        }
+
+        //! \return The number of Ports with a value per instance.
+        [[nodiscard]]std::size_t numSlots() const
+        {
+            return _slots.size();
+        }
+
+        //! \return The size in bytes of the block of one instance, without its strings.
+        [[nodiscard]]std::size_t stride() const
+        {
+            return _stride;
+        }
+
+        //! \return The value of a double Port for one instance, or nullptr if it has none.
+        [[nodiscard]]double* doubles(std::size_t instance, const dagbase::Port& port) const
+        {
+            return static_cast<double*>(data(instance, port, dagbase::PortType::TYPE_DOUBLE));
+        }
+
+        //! \return The value of an int64 Port for one instance, or nullptr if it has none.
+        [[nodiscard]]std::int64_t* int64s(std::size_t instance, const dagbase::Port& port) const
+        {
+            return static_cast<std::int64_t*>(data(instance, port, dagbase::PortType::TYPE_INT64));
+        }
+
+        //! \return The value of a bool Port for one instance, or nullptr if it has none.
+        [[nodiscard]]bool* bools(std::size_t instance, const dagbase::Port& port) const
+        {
+            return static_cast<bool*>(data(instance, port, dagbase::PortType::TYPE_BOOL));
+        }
+
+        //! \return The value of a string Port for one instance, or nullptr if it has none.
+        [[nodiscard]]std::string* strings(std::size_t instance, const dagbase::Port& port);
+
+        [[nodiscard]]void* data(std::size_t instance, const dagbase::Port& port, dagbase::PortType::Type type) const;
+
+        //! Run the transfers into the Node at index within the block of instance,
+        //! then load the Ports of the Node from the block.
+        void load(std::size_t instance, std::size_t index);
+
+        //! Store the outputs of the Node at index into the block of instance.
+        void store(std::size_t instance, std::size_t index);
+
+        //! Run the transfers into Delay Nodes within the block of instance.
+        void commitFeedback(std::size_t instance);
+    private:
+        static constexpr std::uint32_t NO_SLOT = ~std::uint32_t{0};
+
+        struct Slot
+        {
+            dagbase::Port* port{nullptr};
+            dagbase::PortType::Type type{dagbase::PortType::TYPE_UNKNOWN};
+            //! The index of the value in the block, or in _strings for a string
+            std::uint32_t offset{0};
+            bool isOutput{false};
+            //! Set when the Port is a TypedPort, to avoid the value visitors
+            dagbase::TypedPort<double>* doublePort{nullptr};
+            dagbase::TypedPort<std::int64_t>* int64Port{nullptr};
+            dagbase::TypedPort<bool>* boolPort{nullptr};
+        };
+
+        //! A copy between two slots, or from a Port outside the plan when source is NO_SLOT.
+        struct SlotTransfer
+        {
+            std::uint32_t source{NO_SLOT};
+            std::uint32_t dest{NO_SLOT};
+            dagbase::Port* sourcePort{nullptr};
+        };
+
+        std::uint32_t addSlot(dagbase::Port* port);
+
+        void copy(std::size_t instance, const SlotTransfer& transfer);
+
+        [[nodiscard]]dagbase::Value get(std::size_t instance, const Slot& slot) const;
+
+        void set(std::size_t instance, const Slot& slot, const dagbase::Value& value);
+
+        void loadSlot(std::size_t instance, const Slot& slot);
+
+        void storeSlot(std::size_t instance, const Slot& slot);
+
+        [[nodiscard]]unsigned char* cell(std::size_t instance, const Slot& slot) const
+        {
+            return _block + instance * _stride + slot.offset * sizeof(double);
+        }
+
+        //! In Node order, so that each block is read and written front to back.
+        std::vector<Slot> _slots;
+        std::unordered_map<const dagbase::Port*, std::uint32_t> _slotIndex;
+        //! The slots of Node i are [_firstSlot[i], _firstSlot[i+1]) in _nodeSlots
+        std::vector<std::uint32_t> _firstSlot;
+        std::vector<std::uint32_t> _nodeSlots;
+        //! Indexed like the transfers of the plan
+        std::vector<SlotTransfer> _transfers;
+        //! The transfers into Node i are [_firstTransfer[i], _firstTransfer[i+1]) in _transfers
+        std::vector<std::uint32_t> _firstTransfer;
+        std::vector<SlotTransfer> _feedback;
+        unsigned char* _block{nullptr};
+        //! The strings of every instance, _numStrings per instance
+        std::vector<std::string> _strings;
+        std::size_t _numStrings{0};
+        std::size_t _numInstances{0};
+        std::size_t _stride{0};
+    };
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "config/Export.h"
+
+#include "core/Types.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace dag
+{
+    class EvaluationPlan;
+
+    //! The Nodes of an EvaluationPlan that can reach a CAT_SINK Node or a pinned Port.
+    //! \note Without pruning every Node is live. With pruning, no sinks and no pins every Node is dead.
+    class DAG_API Liveness
+    {
+    public:
+        void setPruning(bool prune)
+        {
+            _prune = prune;
+        }
+
+        [[nodiscard]]bool isPruning() const
+        {
+            return _prune;
+        }
+
+        //! Keep the Node that produces the value of the Port with the given id alive.
+        //! \retval false The Port was already pinned.
+        bool pin(dagbase::PortID id);
+
+        //! \retval false The Port was not pinned.
+        bool unpin(dagbase::PortID id);
+
+        //! Find the live Nodes of plan.
+        void compile(const EvaluationPlan& plan);
+
+        [[nodiscard]]bool isLive(std::size_t index) const
+        {
+            return _dead.empty() || _dead[index] == 0;
+        }
+
+        [[nodiscard]]std::uint32_t numLive() const
+        {
+            return _numLive;
+        }
+    private:
+        //! Per Node, 1 if pruning and the Node reaches no sink or pinned Port
+        std::vector<std::uint8_t> _dead;
+        std::vector<dagbase::PortID> _pinned;
+        std::uint32_t _numLive{0};
+        bool _prune{false};
+    };
+}
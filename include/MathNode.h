@@ -9,19 +9,31 @@
 #include "core/Node.h"
 #include "core/TypedPort.h"
 #include "core/KeyGenerator.h"
+#include "BatchContext.h"
+#include "FastMath.h"
+#include "InlinePorts.h"
 
 namespace dag
 {
-    class DAG_API MathsNode : public dagbase::Node
+    //! Computes the sine of its angle, in the unit given by the value of its unit Port.
+    class DAG_API MathsNode : public dagbase::Node, public BatchNode
     {
+    public:
+        //! The values of the unit Port
+        enum Unit : std::int64_t
+        {
+            UNIT_RADIANS,
+            UNIT_DEGREES,
+            UNIT_GRADIANS
+        };
     public:
         MathsNode(dagbase::KeyGenerator& keyGen, const std::string& name, dagbase::NodeCategory::Category category)
         :
         Node(keyGen, name, category)
         {
-            _angle = new dagbase::TypedPort<double>(keyGen.nextPortID(), this, "angle", dagbase::PortType::TYPE_DOUBLE, dagbase::PortDirection::DIR_IN, 0.0);
-            _unit = new dagbase::TypedPort<std::int64_t>(keyGen.nextPortID(), this, "unit", dagbase::PortType::TYPE_INT64, dagbase::PortDirection::DIR_INTERNAL, 0);
-            _output = new dagbase::TypedPort<double>(keyGen.nextPortID(), this, "output", dagbase::PortType::TYPE_DOUBLE, dagbase::PortDirection::DIR_OUT, 0.0);
+            _angle = _portStorage.emplace<0>(keyGen.nextPortID(), this, "angle", dagbase::PortType::TYPE_DOUBLE, dagbase::PortDirection::DIR_IN, 0.0);
+            _unit = _portStorage.emplace<1>(keyGen.nextPortID(), this, "unit", dagbase::PortType::TYPE_INT64, dagbase::PortDirection::DIR_INTERNAL, 0);
+            _output = _portStorage.emplace<2>(keyGen.nextPortID(), this, "output", dagbase::PortType::TYPE_DOUBLE, dagbase::PortDirection::DIR_OUT, 0.0);
         }
 
         MathsNode(dagbase::InputStream& str, dagbase::NodeLibrary& nodeLib, dagbase::Lua &lua);
@@ -75,14 +87,60 @@ namespace dag
         }
 
         void update() override;
+
+        //! Choose between std::sin and the polynomials of FastMath.
+        //! \note The accuracy is not saved with the Node.
+        void setAccuracy(FastMath::Accuracy accuracy)
+        {
+            _accuracy = accuracy;
+        }
+
+        [[nodiscard]]FastMath::Accuracy accuracy() const
+        {
+            return _accuracy;
+        }
+
+        //! \return The factor that converts the unit of the angle to radians, one for an unknown unit.
+        [[nodiscard]]double scale() const
+        {
+            switch (_unit->value())
+            {
+            case UNIT_DEGREES:
+                return 1.74532925199432957692e-02;
+            case UNIT_GRADIANS:
+                return 1.57079632679489661923e-02;
+            default:
+                return 1.0;
+            }
+        }
+
+        //! \return The output update() computes for angle, without touching the Ports.
+        [[nodiscard]]double apply(double angle) const
+        {
+            return FastMath::sin(angle * scale(), _accuracy);
+        }
+
+        [[nodiscard]]dagbase::TypedPort<double>* angle() const
+        {
+            return _angle;
+        }
+
+        [[nodiscard]]dagbase::TypedPort<double>* output() const
+        {
+            return _output;
+        }
+
+        void updateBatch(BatchContext& context, std::size_t n) override;
     protected:
         static std::array<dagbase::MetaPort, 3> ports;
         static constexpr size_t firstPort = 0;
         static constexpr size_t numPorts = 3;
     private:
+        InlinePorts<dagbase::TypedPort<double>, dagbase::TypedPort<std::int64_t>, dagbase::TypedPort<double>> _portStorage;
         dagbase::TypedPort<double>* _angle{nullptr};
         dagbase::TypedPort<std::int64_t>* _unit{nullptr};
         dagbase::TypedPort<double>* _output{nullptr};
+        FastMath::Accuracy _accuracy{FastMath::ACCURACY_EXACT};
     };
 
 
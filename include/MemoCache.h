@@ -0,0 +1,83 @@
+#pragma once
+
+#include "config/Export.h"
+
+#include "core/Value.h"
+#include "core/Variant.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace dagbase
+{
+    class Port;
+}
+
+namespace dag
+{
+    //! A bounded least-recently-used map from the input values of a child Graph to its output values.
+    class DAG_API MemoCache
+    {
+    public:
+        typedef std::vector<dagbase::Value> ValueArray;
+    public:
+        explicit MemoCache(std::size_t capacity);
+
+        //! Append the value of port to key.
+        //! \retval false The type of port cannot be part of a key, so the inputs cannot be cached.
+        static bool appendKey(const dagbase::Port& port, std::string& key);
+
+        //! \return The outputs cached for key, or nullptr on a miss.
+        //! \note A hit makes key the most recently used.
+        const ValueArray* lookup(const std::string& key);
+
+        //! Cache outputs for key, evicting the least recently used entry when full.
+        void insert(const std::string& key, ValueArray outputs);
+
+        //! Forget every entry but keep the counters.
+        void clear();
+
+        [[nodiscard]]std::size_t size() const
+        {
+            return _entries.size();
+        }
+
+        [[nodiscard]]std::size_t capacity() const
+        {
+            return _capacity;
+        }
+
+        [[nodiscard]]std::uint32_t numHits() const
+        {
+            return _numHits;
+        }
+
+        [[nodiscard]]std::uint32_t numMisses() const
+        {
+            return _numMisses;
+        }
+
+        dagbase::Variant find(std::string_view path) const;
+    private:
+        struct Entry
+        {
+            std::string key;
+            ValueArray outputs;
+        };
+
+        typedef std::list<Entry> EntryList;
+
+        //! Most recently used first.
+        EntryList _entries;
+        std::unordered_map<std::string, EntryList::iterator> _index;
+        std::size_t _capacity{0};
+        std::uint32_t _numHits{0};
+        std::uint32_t _numMisses{0};
+        std::uint32_t _numEvictions{0};
+    };
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include "config/Export.h"
+
+#include "core/Types.h"
+#include "core/Variant.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+namespace dagbase
+{
+    class Node;
+}
+
+namespace dag
+{
+    class Boundary;
+    class EvaluationPlan;
+    class MemoCache;
+
+    //! The GraphNodes of an EvaluationPlan whose child Graph is skipped when its inputs were seen before.
+    //! The input Boundary of the child looks up its values in a MemoCache, and on a hit the outputs are
+    //! restored and every Node of the child Graph that depends on the inputs is skipped for the frame.
+    class DAG_API Memoisation
+    {
+    public:
+        typedef std::vector<std::uint32_t> IndexArray;
+
+        //! The memo of a Node that is not part of a memoised child Graph.
+        static constexpr std::uint32_t NO_MEMO = ~std::uint32_t{0};
+    public:
+        Memoisation() = default;
+
+        Memoisation(const Memoisation&) = delete;
+
+        Memoisation& operator=(const Memoisation&) = delete;
+
+        ~Memoisation();
+
+        //! Cache the outputs of the child Graph of a GraphNode, see EvaluationPlan::setMemoise().
+        //! \param capacity The number of input values remembered, zero to stop caching.
+        void setMemoise(dagbase::NodeID graphNode, std::size_t capacity);
+
+        //! Find the memoised GraphNodes in order before it is flattened.
+        //! \param unflattened Receives the Boundaries that must stay in the plan.
+        void find(const std::vector<dagbase::Node*>& order, std::unordered_set<const dagbase::Node*>& unflattened);
+
+        //! Locate the entry, the exit and the Nodes of each memo in plan, following the successors
+        //! of the entry so that the result does not depend on where the exit sorts.
+        void index(const EvaluationPlan& plan);
+
+        [[nodiscard]]bool isEmpty() const
+        {
+            return _memos.empty();
+        }
+
+        [[nodiscard]]std::size_t numMemos() const
+        {
+            return _memos.size();
+        }
+
+        //! Forget the hits of the previous frame.
+        void beginFrame();
+
+        //! \return true if the Node at index is skipped because its memo hit this frame.
+        [[nodiscard]]bool skips(std::size_t index) const
+        {
+            const auto memo = _memoOf[index];
+
+            return memo != NO_MEMO && _memos[memo].hit;
+        }
+
+        //! Look up the inputs after the entry of a memo ran, and cache the outputs once both the
+        //! entry and the exit ran.
+        void afterNode(std::size_t index);
+
+        //! \return Per Node, the memo that skips it on a hit or NO_MEMO.
+        [[nodiscard]]const IndexArray& regions() const
+        {
+            return _memoOf;
+        }
+
+        //! \return The hits of every cache together.
+        [[nodiscard]]std::uint32_t numHits() const;
+
+        [[nodiscard]]std::uint32_t numMisses() const;
+
+        //! Find the counters of the cache of a GraphNode as memos[<NodeID>].numHits and so on, see MemoCache::find().
+        dagbase::Variant find(std::string_view path) const;
+    private:
+        void beginMemo(std::uint32_t memo);
+
+        void endMemo(std::uint32_t memo);
+
+        struct Memo
+        {
+            MemoCache* cache{nullptr};
+            Boundary* input{nullptr};
+            Boundary* output{nullptr};
+            std::vector<dagbase::Node*> region;
+            std::uint32_t entry{NO_MEMO};
+            std::uint32_t exit{NO_MEMO};
+            //! The later of the entry and the exit in plan order, after which the outputs are cached
+            std::uint32_t close{NO_MEMO};
+            std::string key;
+            bool cacheable{false};
+            bool hit{false};
+        };
+        struct MemoSetting
+        {
+            dagbase::NodeID graphNode;
+            MemoCache* cache{nullptr};
+        };
+        std::vector<MemoSetting> _settings;
+        std::vector<Memo> _memos;
+        //! Per Node, the Memo whose entry it is
+        IndexArray _memoEntry;
+        //! Per Node, the Memo that it closes
+        IndexArray _memoClose;
+        //! Per Node, the Memo that skips it on a hit
+        IndexArray _memoOf;
+    };
+}
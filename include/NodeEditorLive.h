@@ -7,8 +7,11 @@
 #include "config/Export.h"
 
 #include "NodeEditorInterface.h"
+#include "EvaluationPlan.h"
 #include "core/Variant.h"
 
+#include <chrono>
+#include <unordered_map>
 #include <vector>
 #include <functional>
 #include <string_view>
@@ -23,9 +26,16 @@ namespace dagbase
 
 namespace dag
 {
+    class BatchContext;
+    class DataflowExecutor;
+    class EvaluationProfile;
+    class InstanceState;
+    class EvaluationCursor;
     class Graph;
     class MemoryNodeLibrary;
     class SelectionLive;
+    class ThreadPool;
+    class TopologicalOrder;
 
     class DAG_API NodeEditorLive : public NodeEditorInterface
     {
@@ -106,15 +116,183 @@ namespace dag
 
         dagbase::Status deserialise(dagbase::InputStream& str, dagbase::Lua &lua);
 
+        //! Evaluate the root Graph using the cached EvaluationPlan.
+        //! \note The plan is only recompiled after an edit that changes the topology.
+        dagbase::Status evaluate();
+
+        //! Evaluate only the Nodes affected by setValue() since the last evaluation.
+        //! \note The first evaluation after a compile updates every Node. A value written directly to a
+        //! PrimitivePort is seen through its change count, see EvaluationPlan::evaluateDirty(). A value
+        //! written directly to any other Port is only seen once something else marks its Node dirty.
+        dagbase::Status evaluateDirty();
+
+        //! Evaluate just enough of the Graph to bring the value of one Port up to date.
+        //! \note The upstream cone is cached until the next edit that changes the topology.
+        //! \retval STATUS_OBJECT_NOT_FOUND There is no Port with the given id in the active Graph.
+        dagbase::Status evaluateFor(dagbase::PortID id);
+
+        //! Allocate arrays of n samples for the double and int64 Ports, see batchDoubles() and batchInt64s().
+        //! \note The arrays are discarded by the next edit that changes the topology.
+        dagbase::Status prepareBatch(std::size_t n);
+
+        //! Evaluate every sample prepared by prepareBatch().
+        //! \retval STATUS_OBJECT_NOT_FOUND The batch was not prepared since the last edit.
+        dagbase::Status evaluateBatch();
+
+        //! \return The samples of a double Port in the active Graph, or nullptr if it has none.
+        double* batchDoubles(dagbase::PortID id);
+
+        //! \return The samples of an int64 Port in the active Graph, or nullptr if it has none.
+        std::int64_t* batchInt64s(dagbase::PortID id);
+
+        //! Give each of n instances of the root Graph its own block of Port values,
+        //! see instanceDoubles() and friends. The Nodes themselves are shared.
+        //! \note The blocks are discarded by the next edit that changes the topology.
+        //! \retval STATUS_INVALID_PORT A Port is not a double, int64, bool or string.
+        dagbase::Status prepareInstances(std::size_t n);
+
+        //! Evaluate every instance prepared by prepareInstances().
+        //! \retval STATUS_OBJECT_NOT_FOUND The instances were not prepared since the last edit.
+        dagbase::Status evaluateInstances();
+
+        //! \return The value of a double Port in the active Graph for one instance, or nullptr if it has none.
+        double* instanceDoubles(std::size_t instance, dagbase::PortID id);
+
+        //! \return The value of an int64 Port in the active Graph for one instance, or nullptr if it has none.
+        std::int64_t* instanceInt64s(std::size_t instance, dagbase::PortID id);
+
+        //! \return The value of a bool Port in the active Graph for one instance, or nullptr if it has none.
+        bool* instanceBools(std::size_t instance, dagbase::PortID id);
+
+        //! \return The value of a string Port in the active Graph for one instance, or nullptr if it has none.
+        std::string* instanceStrings(std::size_t instance, dagbase::PortID id);
+
+        //! Evaluate the active Graph a slice at a time, resuming where the previous call stopped,
+        //! see EvaluationCursor. A change that recompiles the plan restarts the frame.
+        //! \param budget The time after which to stop, at least one Node runs per call.
+        //! \param finished Set to true if the frame ended.
+        //! \retval STATUS_CYCLE_DETECTED The Graph has a cycle, so it cannot be evaluated.
+        dagbase::Status evaluateWithin(std::chrono::nanoseconds budget, bool& finished);
+
+        //! Choose whether evaluateWithin() keeps a copy of the values at the end of each frame,
+        //! see snapshotDoubles() and snapshotInt64s().
+        void setSnapshot(bool snapshot);
+
+        //! \return The value of a double Port at the end of the last frame of evaluateWithin(),
+        //! or nullptr without a snapshot or if the Port has none.
+        const double* snapshotDoubles(dagbase::PortID id) const;
+
+        const std::int64_t* snapshotInt64s(dagbase::PortID id) const;
+
+        //! Set the value of a Port and mark its Node for evaluateDirty().
+        //! \note This is the only way to mark a Node dirty, Ports do not report their own changes.
+        //! \retval STATUS_OBJECT_NOT_FOUND There is no Port with the given id in the active Graph.
+        dagbase::Status setValue(dagbase::PortID id, const dagbase::Value& value);
+
+        //! Set the number of threads used by evaluate().
+        //! \param numThreads One to evaluate serially, zero for one thread per hardware thread.
+        void setNumThreads(std::size_t numThreads);
+
+        //! Choose whether evaluation inlines child Graphs by collapsing Boundary pass-throughs.
+        //! \note On by default, the editable structure of the Graph is unchanged either way.
+        void setFlattenBoundaries(bool flatten)
+        {
+            _plan->setFlattenBoundaries(flatten);
+        }
+
+        //! Choose whether evaluation skips Nodes whose inputs cannot change, see EvaluationPlan::setFoldConstants().
+        //! \note Off by default. Values set through setValue() are seen, as are values written directly to a
+        //! PrimitivePort before evaluateDirty(). Other values written directly to Ports are not.
+        void setFoldConstants(bool fold)
+        {
+            _plan->setFoldConstants(fold);
+        }
+
+        //! Choose whether evaluation runs chains of MathsNode as one kernel, see EvaluationPlan::setFuseChains().
+        //! \note Off by default. The Graph is unchanged, only the plan is.
+        void setFuseChains(bool fuse)
+        {
+            _plan->setFuseChains(fuse);
+        }
+
+        //! Choose whether batch inputs share the array of a same-typed output, see EvaluationPlan::setZeroCopy().
+        //! \note On by default. batchDoubles() of a shared input then returns the array of its output.
+        void setZeroCopy(bool zeroCopy)
+        {
+            _plan->setZeroCopy(zeroCopy);
+        }
+
+        //! Choose whether evaluation skips Nodes that feed no CAT_SINK Node and no pinned Port.
+        //! \note Off by default. evaluateFor() still updates dead Nodes in the cone of its Port.
+        void setPruneDeadNodes(bool prune)
+        {
+            _plan->setPruneDeadNodes(prune);
+        }
+
+        //! Cache the outputs of a GraphNode against its input values, see EvaluationPlan::setMemoise().
+        //! \param capacity The number of input values remembered, zero to stop caching.
+        //! \retval STATUS_OBJECT_NOT_FOUND There is no GraphNode with the given id in the active Graph.
+        dagbase::Status setMemoise(dagbase::NodeID id, std::size_t capacity);
+
+        //! Run a Node only on every divisor-th frame, see EvaluationPlan::setDivisor().
+        //! \param divisor One or zero to run the Node on every frame.
+        //! \retval STATUS_OBJECT_NOT_FOUND There is no Node with the given id in the active Graph.
+        dagbase::Status setDivisor(dagbase::NodeID id, std::uint32_t divisor);
+
+        //! Keep the producer of a Port alive when pruning dead Nodes, for Ports that are read from outside the Graph.
+        //! \retval STATUS_OBJECT_NOT_FOUND There is no Port with the given id in the active Graph.
+        dagbase::Status pinPort(dagbase::PortID id);
+
+        //! \retval STATUS_OBJECT_NOT_FOUND There is no Port with the given id in the active Graph.
+        dagbase::Status unpinPort(dagbase::PortID id);
+
+        //! Choose whether evaluate() times every update() and transfer, found under profile in find().
+        //! \note Profiled evaluation is serial. Turning profiling off keeps the timings only to weigh
+        //! the critical path of SCHEDULER_CRITICAL_PATH, see EvaluationPlan::weighCriticalPath().
+        void setProfiling(bool profiling);
+
+        //! \return The timings of the last profiled evaluations, or nullptr when not profiling.
+        [[nodiscard]]const EvaluationProfile* profile() const
+        {
+            return _profile;
+        }
+
+        //! Choose how evaluate() shares the work between threads when there is more than one.
+        void setScheduler(EvaluationPlan::Scheduler scheduler)
+        {
+            _scheduler = scheduler;
+        }
+
         dagbase::Variant find(std::string_view path) const;
 
         void debug();
     private:
+        //! Compile the plan from the incrementally maintained order, rebuilding the order if an edit discarded it.
+        dagbase::Status compilePlan();
+
+        //! Delete the Transfer made when the SignalPath with the given id was connected.
+        void releaseTransfer(dagbase::SignalPathID id);
+
+        //! Delete every Transfer, typically because the Graph was replaced.
+        void clearTransfers();
+
         MemoryNodeLibrary *_nodeLib{nullptr};
         dagbase::Graph* _graph{nullptr};
         dagbase::Graph* _activeGraph{nullptr};
         SelectionLive* _selection{nullptr};
-        typedef std::vector<dagbase::Transfer*> TransferArray;
-        TransferArray _transfers;
+        EvaluationPlan* _plan{nullptr};
+        ThreadPool* _threadPool{nullptr};
+        DataflowExecutor* _dataflow{nullptr};
+        BatchContext* _batch{nullptr};
+        TopologicalOrder* _order{nullptr};
+        EvaluationProfile* _profile{nullptr};
+        //! The timings of the last profiling session
+        EvaluationProfile* _costs{nullptr};
+        InstanceState* _instances{nullptr};
+        EvaluationCursor* _cursor{nullptr};
+        EvaluationPlan::Scheduler _scheduler{EvaluationPlan::SCHEDULER_LEVELS};
+        //! The Transfer made by each SignalPath, by SignalPathID, deleted along with the SignalPath
+        typedef std::unordered_map<std::uint32_t, dagbase::Transfer*> TransferMap;
+        TransferMap _transfers;
     };
 }
\ No newline at end of file
@@ -8,6 +8,8 @@
 #include "core/Types.h"
 #include "core/KeyGenerator.h"
 #include "core/CloningFacility.h"
+#include "PortTable.h"
+#include "InlinePorts.h"
 
 #include <string>
 #include <array>
@@ -20,12 +22,12 @@ namespace dagbase
 
 namespace dag
 {
-    class DAG_API Base : public dagbase::Node
+    class DAG_API Base : public PortTableNode<Base>
     {
     public:
         Base(dagbase::KeyGenerator& keyGen, const std::string& name, dagbase::NodeCategory::Category category)
                 :
-                Node(keyGen, name, category),
+                PortTableNode(keyGen, name, category),
                 int1(0.0),
                 _direction(new dagbase::TypedPort<double>(keyGen.nextPortID(), this, "direction", dagbase::PortType::TYPE_DOUBLE, dagbase::PortDirection::DIR_OUT, 1.0))
         {
@@ -56,65 +58,23 @@ namespace dag
 
         double int1;
 
-        [[nodiscard]]size_t totalPorts() const override
-        {
-            return numPorts;
-        }
-
-        [[nodiscard]]const dagbase::MetaPort * dynamicMetaPort(size_t index) const override
-        {
-            return metaPort(index);
-        }
-
-        [[nodiscard]]dagbase::MetaPort * dynamicMetaPort(size_t index) override
-        {
-            return metaPort(index);
-        }
+        //! The built-in Ports of Base.
+        static const PortTable<1> portTable;
 
-        dagbase::Port* dynamicPort(size_t index) override
-        {
-            if (index == 0)
-            {
-                return _direction;
-            }
-
-            return nullptr;
-        }
-        const dagbase::Port* dynamicPort(size_t index) const override
-        {
-            if (index == 0)
-            {
-                return _direction;
-            }
-
-            return nullptr;
-        }
-
-        static dagbase::MetaPort* metaPort(size_t index)
-        {
-            if (index < firstPort + numPorts)
-            {
-                return &ports[index-firstPort];
-            }
-
-            return nullptr;
-        }
         dagbase::InputStream& readFromStream(dagbase::InputStream& str, dagbase::NodeLibrary& nodeLib, dagbase::Lua& lua) override;
     protected:
         static std::array<dagbase::MetaPort, 1> ports;
-        static constexpr size_t firstPort = 0;
-        static constexpr size_t numPorts = ports.size();
         Base() = default;
     private:
         dagbase::TypedPort<double>* _direction{ nullptr };
     };
 
-    class DAG_API Derived : public Base
+    class DAG_API Derived : public PortTableNode<Derived, Base>
     {
     public:
         Derived(dagbase::KeyGenerator& keyGen, const std::string& name, dagbase::NodeCategory::Category category)
                 :
-                Base(keyGen, name,category),
+                PortTableNode(keyGen, name,category),
                 _trigger(new dagbase::TypedPort<bool>(keyGen.nextPortID(), this, "trigger", dagbase::PortType::TYPE_BOOL, dagbase::PortDirection::DIR_IN, true))
         {
             // Do nothing.
@@ -135,62 +95,8 @@ namespace dag
 
         bool equals(const Node& other, dagbase::ComparisonFlags flags) const override;
 
-        [[nodiscard]]static dagbase::MetaPort * metaPort(size_t index)
-        {
-            if (index < firstPort)
-            {
-                return Base::metaPort(index);
-            }
-            if (index < firstPort + numPorts)
-            {
-                return &ports[index-firstPort];
-            }
-
-            return nullptr;
-        }
-
-        [[nodiscard]]size_t totalPorts() const override
-        {
-            return Base::totalPorts() + numPorts;
-        }
-
-        [[nodiscard]]dagbase::MetaPort const* dynamicMetaPort(size_t index) const override
-        {
-            return metaPort(index);
-        }
-
-        [[nodiscard]]dagbase::MetaPort* dynamicMetaPort(size_t index) override
-        {
-            return metaPort(index);
-        }
-
-        [[nodiscard]]dagbase::Port* dynamicPort(size_t index) override
-        {
-            if (index<firstPort)
-            {
-                return Base::dynamicPort(index);
-            }
-            if (index == 1)
-            {
-                return _trigger;
-            }
-
-            return nullptr;
-        }
-
-        [[nodiscard]]const dagbase::Port* dynamicPort(size_t index) const override
-        {
-            if (index<firstPort)
-            {
-                return Base::dynamicPort(index);
-            }
-            if (index == 1)
-            {
-                return _trigger;
-            }
-
-            return nullptr;
-        }
+        //! The built-in Ports of Base, then those of Derived.
+        static const PortTable<2> portTable;
 
         const char* className() const override
         {
@@ -200,8 +106,6 @@ namespace dag
         dagbase::InputStream& readFromStream(dagbase::InputStream& str, dagbase::NodeLibrary& nodeLib, dagbase::Lua& lua) override;
     protected:
         static std::array<dagbase::MetaPort, 1> ports;
-        static constexpr size_t firstPort = Base::numPorts;
-        static constexpr size_t numPorts = 1;
         Derived() = default;
     private:
         dagbase::TypedPort<bool>* _trigger{ nullptr };
@@ -279,21 +183,19 @@ namespace dag
             return "Final";
         }
 
+        //! The built-in Ports of Base and Derived, then those of Final. The dynamic Ports follow them.
+        static const PortTable<3> portTable;
+
         [[nodiscard]]const dagbase::MetaPort * dynamicMetaPort(size_t index) const override
         {
-            if (index < firstPort)
-            {
-                return Derived::dynamicMetaPort(index);
-            }
-
-            if (index < firstPort + numPorts)
+            if (index < portTable.size())
             {
-                return &ports[index-firstPort];
+                return portTable.metaPort(index);
             }
 
-            if (index < firstPort + numPorts + _dynamicMetaPorts.size())
+            if (index < portTable.size() + _dynamicMetaPorts.size())
             {
-                return &_dynamicMetaPorts[index - (firstPort+numPorts)];
+                return &_dynamicMetaPorts[index - portTable.size()];
             }
 
             return nullptr;
@@ -301,19 +203,14 @@ namespace dag
 
         [[nodiscard]]dagbase::MetaPort * dynamicMetaPort(size_t index) override
         {
-            if (index < firstPort)
+            if (index < portTable.size())
             {
-                return Derived::dynamicMetaPort(index);
+                return portTable.metaPort(index);
             }
 
-            if (index < firstPort + numPorts)
+            if (index < portTable.size() + _dynamicMetaPorts.size())
             {
-                return &ports[index-firstPort];
-            }
-
-            if (index < firstPort + numPorts + _dynamicMetaPorts.size())
-            {
-                return &_dynamicMetaPorts[index - (firstPort+numPorts)];
+                return &_dynamicMetaPorts[index - portTable.size()];
             }
 
             return nullptr;
@@ -321,24 +218,19 @@ namespace dag
 
         [[nodiscard]]size_t totalPorts() const override
         {
-            return Derived::totalPorts() + numPorts + _dynamicMetaPorts.size();
+            return portTable.size() + _dynamicMetaPorts.size();
         }
 
         [[nodiscard]]dagbase::Port* dynamicPort(size_t index) override
         {
-            if (index<firstPort)
+            if (index < portTable.size())
             {
-                return Derived::dynamicPort(index);
+                return portTable.port(*this, index);
             }
 
-            if (index == firstPort)
+            if (index < portTable.size() + _dynamicPorts.size())
             {
-                return _int1;
-            }
-
-            if (index < firstPort + numPorts + _dynamicPorts.size())
-            {
-                return _dynamicPorts.a[index - (firstPort+numPorts)];
+                return _dynamicPorts.a[index - portTable.size()];
             }
 
             return nullptr;
@@ -346,19 +238,14 @@ namespace dag
 
         [[nodiscard]]const dagbase::Port* dynamicPort(size_t index) const override
         {
-            if (index<firstPort)
-            {
-                return Derived::dynamicPort(index);
-            }
-
-            if (index == firstPort)
+            if (index < portTable.size())
             {
-                return _int1;
+                return portTable.port(*this, index);
             }
 
-            if (index < firstPort + numPorts + _dynamicPorts.size())
+            if (index < portTable.size() + _dynamicPorts.size())
             {
-                return _dynamicPorts.a[index - (firstPort+numPorts)];
+                return _dynamicPorts.a[index - portTable.size()];
             }
 
             return nullptr;
@@ -368,28 +255,26 @@ namespace dag
         static std::array<dagbase::MetaPort, 1> ports;
         MetaPortArray _dynamicMetaPorts;
         PortArray _dynamicPorts;
-        static constexpr size_t firstPort = Derived::firstPort + Derived::numPorts;
-        static constexpr size_t numPorts = 1;
     };
 
-    class DAG_API FooTyped : public dagbase::Node
+    class DAG_API FooTyped : public PortTableNode<FooTyped>
     {
     public:
         FooTyped(dagbase::KeyGenerator& keyGen, const std::string& name, dagbase::NodeCategory::Category category)
                 :
-                Node(keyGen, name, category)
+                PortTableNode(keyGen, name, category)
         {
-            _in1 = new dagbase::TypedPort<double>(keyGen.nextPortID(), this, "in1", dagbase::PortType::TYPE_DOUBLE, dagbase::PortDirection::DIR_IN, 1.0);
+            _in1 = _portStorage.emplace<0>(keyGen.nextPortID(), this, "in1", dagbase::PortType::TYPE_DOUBLE, dagbase::PortDirection::DIR_IN, 1.0);
         }
 
         FooTyped(const FooTyped& other, dagbase::CloningFacility& facility, dagbase::CopyOp copyOp, dagbase::KeyGenerator* keyGen)
                 :
-                Node(other, facility, copyOp, keyGen)
+                PortTableNode(other, facility, copyOp, keyGen)
         {
             std::uint64_t in1Id = 0;
             if (facility.putOrig(other._in1, &in1Id))
             {
-                _in1 = new dagbase::TypedPort(*other._in1, facility, copyOp, keyGen);
+                _in1 = _portStorage.emplace<0>(*other._in1, facility, copyOp, keyGen);
             }
             else
             {
@@ -423,79 +308,36 @@ namespace dag
             return *_in1;
         }
 
-        [[nodiscard]]size_t totalPorts() const override
-        {
-            return size_t{1};
-        }
-
-        dagbase::Port* dynamicPort(size_t index) override
-        {
-            if (index == 0)
-            {
-                return _in1;
-            }
-
-            return nullptr;
-        }
-
-        const dagbase::Port* dynamicPort(size_t index) const override
-        {
-            if (index == 0)
-            {
-                return _in1;
-            }
-
-            return nullptr;
-        }
-
-        static dagbase::MetaPort* metaPort(size_t index)
-        {
-            if (index < firstPort + numPorts)
-            {
-                return &ports[index-firstPort];
-            }
-
-            return nullptr;
-        }
-
-        [[nodiscard]]const dagbase::MetaPort * dynamicMetaPort(size_t index) const override
-        {
-            return metaPort(index);
-        }
-
-        [[nodiscard]]dagbase::MetaPort * dynamicMetaPort(size_t index) override
-        {
-            return metaPort(index);
-        }
+        //! The built-in Ports of FooTyped.
+        static const PortTable<1> portTable;
 
         void debug(dagbase::DebugPrinter& printer) const override;
     protected:
         static std::array<dagbase::MetaPort, 1> ports;
-        static constexpr size_t firstPort = 0;
-        static constexpr size_t numPorts = 1;
     private:
+        InlinePorts<dagbase::TypedPort<double>> _portStorage;
         dagbase::TypedPort<double>* _in1{nullptr};
     };
 
-    class DAG_API BarTyped : public dagbase::Node
+    class DAG_API BarTyped : public PortTableNode<BarTyped>
     {
     public:
         BarTyped() = default;
         BarTyped(dagbase::KeyGenerator& keyGen, const std::string& name, dagbase::NodeCategory::Category category)
                 :
-                Node(keyGen, name, category)
+                PortTableNode(keyGen, name, category)
         {
-            _out1 = new dagbase::TypedPort<double>(keyGen.nextPortID(), this, "out1", dagbase::PortType::TYPE_DOUBLE, dagbase::PortDirection::DIR_OUT, 1.0);
+            _out1 = _portStorage.emplace<0>(keyGen.nextPortID(), this, "out1", dagbase::PortType::TYPE_DOUBLE, dagbase::PortDirection::DIR_OUT, 1.0);
         }
 
         BarTyped(const BarTyped& other,dagbase::CloningFacility& facility, dagbase::CopyOp copyOp, dagbase::KeyGenerator* keyGen)
                 :
-                Node(other,facility,copyOp,keyGen)
+                PortTableNode(other,facility,copyOp,keyGen)
         {
             std::uint64_t out1Id = 0;
             if (facility.putOrig(other._out1, &out1Id))
             {
-                _out1 = new dagbase::TypedPort(*other._out1, facility, copyOp, keyGen);
+                _out1 = _portStorage.emplace<0>(*other._out1, facility, copyOp, keyGen);
             }
             else
             {
@@ -529,80 +371,37 @@ namespace dag
             return _out1;
         }
 
-        [[nodiscard]]size_t totalPorts() const override
-        {
-            return size_t{1};
-        }
-
-        dagbase::Port* dynamicPort(size_t index) override
-        {
-            if (index == 0)
-            {
-                return _out1;
-            }
-
-            return nullptr;
-        }
-
-        const dagbase::Port* dynamicPort(size_t index) const override
-        {
-            if (index == 0)
-            {
-                return _out1;
-            }
-
-            return nullptr;
-        }
-
-        static dagbase::MetaPort* metaPort(size_t index)
-        {
-            if (index < firstPort + numPorts)
-            {
-                return &ports[index-firstPort];
-            }
-
-            return nullptr;
-        }
-
-        [[nodiscard]]const dagbase::MetaPort * dynamicMetaPort(size_t index) const override
-        {
-            return metaPort(index);
-        }
-
-        [[nodiscard]]dagbase::MetaPort * dynamicMetaPort(size_t index) override
-        {
-            return metaPort(index);
-        }
+        //! The built-in Ports of BarTyped.
+        static const PortTable<1> portTable;
 
         void debug(dagbase::DebugPrinter& printer) const override;
     protected:
         static std::array<dagbase::MetaPort, 1> ports;
-        static constexpr size_t firstPort = 0;
-        static constexpr size_t numPorts = 1;
 
     private:
+        InlinePorts<dagbase::TypedPort<double>> _portStorage;
         dagbase::TypedPort<double>* _out1{nullptr};
     };
 
-    class DAG_API GroupTyped : public dagbase::Node
+    class DAG_API GroupTyped : public PortTableNode<GroupTyped>
     {
     public:
         GroupTyped(dagbase::KeyGenerator& keyGen, const std::string& name, dagbase::NodeCategory::Category category)
                 :
-                Node(keyGen, name, category)
+                PortTableNode(keyGen, name, category)
         {
-            _out1 = new dagbase::TypedPort<double>(keyGen.nextPortID(), this, "out1", dagbase::PortType::TYPE_DOUBLE, dagbase::PortDirection::DIR_OUT, 1.0);
-            _in1 = new dagbase::TypedPort<double>(keyGen.nextPortID(), this, "in1", dagbase::PortType::TYPE_DOUBLE, dagbase::PortDirection::DIR_IN, 2.0);
+            _out1 = _portStorage.emplace<0>(keyGen.nextPortID(), this, "out1", dagbase::PortType::TYPE_DOUBLE, dagbase::PortDirection::DIR_OUT, 1.0);
+            _in1 = _portStorage.emplace<1>(keyGen.nextPortID(), this, "in1", dagbase::PortType::TYPE_DOUBLE, dagbase::PortDirection::DIR_IN, 2.0);
         }
 
         GroupTyped(const GroupTyped& other,dagbase::CloningFacility& facility, dagbase::CopyOp copyOp, dagbase::KeyGenerator* keyGen)
                 :
-                Node(other,facility,copyOp,keyGen)
+                PortTableNode(other,facility,copyOp,keyGen)
         {
             std::uint64_t out1Id = 0;
             if (facility.putOrig(other._out1, &out1Id))
             {
-                _out1 = new dagbase::TypedPort<double>(*other._out1, facility, copyOp, keyGen);
+                _out1 = _portStorage.emplace<0>(*other._out1, facility, copyOp, keyGen);
             }
             else
             {
@@ -612,7 +411,7 @@ namespace dag
             std::uint64_t in1Id = 0;
             if (facility.putOrig(other._in1, &in1Id))
             {
-                _in1 = new dagbase::TypedPort<double>(*other._in1, facility, copyOp, keyGen);
+                _in1 = _portStorage.emplace<1>(*other._in1, facility, copyOp, keyGen);
             }
             else
             {
@@ -659,65 +458,14 @@ namespace dag
             return *_in1;
         }
 
-        dagbase::Port* dynamicPort(size_t index) override
-        {
-            if (index == 0)
-            {
-                return _out1;
-            }
-            if (index == 1)
-            {
-                return _in1;
-            }
-
-            return nullptr;
-        }
-
-        const dagbase::Port* dynamicPort(size_t index) const override
-        {
-            if (index == 0)
-            {
-                return _out1;
-            }
-            if (index == 1)
-            {
-                return _in1;
-            }
-
-            return nullptr;
-        }
-
-        static dagbase::MetaPort* metaPort(size_t index)
-        {
-            if (index < firstPort + numPorts)
-            {
-                return &ports[index-firstPort];
-            }
-
-            return nullptr;
-        }
-
-        [[nodiscard]]size_t totalPorts() const override
-        {
-            return numPorts;
-        }
-
-        [[nodiscard]]const dagbase::MetaPort * dynamicMetaPort(size_t index) const override
-        {
-            return metaPort(index);
-        }
-
-        [[nodiscard]] dagbase::MetaPort * dynamicMetaPort(size_t index) override
-        {
-            return metaPort(index);
-        }
+        //! The built-in Ports of GroupTyped.
+        static const PortTable<2> portTable;
 
         void debug(dagbase::DebugPrinter& printer) const override;
     protected:
         static std::array<dagbase::MetaPort, 2> ports;
-        static constexpr size_t firstPort = 0;
-        static constexpr size_t numPorts = 2;
     private:
+        InlinePorts<dagbase::TypedPort<double>, dagbase::TypedPort<double>> _portStorage;
         dagbase::TypedPort<double>* _out1{nullptr};
         dagbase::TypedPort<double>* _in1{nullptr};
     };
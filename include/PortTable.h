@@ -0,0 +1,161 @@
+#pragma once
+
+#include "core/MetaPort.h"
+#include "core/Node.h"
+
+#include <array>
+#include <cstddef>
+
+namespace dagbase
+{
+    class Port;
+}
+
+namespace dag
+{
+    //! Reads one built-in Port of a Node, see portOf().
+    typedef dagbase::Port* (*PortAccessor)(const dagbase::Node&);
+
+    //! The class that declares a Port member.
+    template<typename Member>
+    struct PortMemberClass;
+
+    template<typename NodeClass, typename PortClass>
+    struct PortMemberClass<PortClass* NodeClass::*>
+    {
+        typedef NodeClass type;
+    };
+
+    //! \return The Port held by Member, a pointer to a Port member of a class derived from dagbase::Node.
+    //! \pre node is an instance of the class that declares Member.
+    template<auto Member>
+    dagbase::Port* portOf(const dagbase::Node& node)
+    {
+        typedef typename PortMemberClass<decltype(Member)>::type NodeClass;
+
+        return static_cast<const NodeClass&>(node).*Member;
+    }
+
+    //! One built-in Port of a Node class and its MetaPort.
+    struct PortEntry
+    {
+        PortAccessor port{nullptr};
+        dagbase::MetaPort* metaPort{nullptr};
+    };
+
+    //! \return The entry for the Port held by Member, described by metaPort.
+    template<auto Member>
+    constexpr PortEntry declarePort(dagbase::MetaPort& metaPort)
+    {
+        return PortEntry{&portOf<Member>, &metaPort};
+    }
+
+    //! The built-in Ports of a Node class in index order, those of its base class first.
+    //! Each class declares its own Ports once, in one static table, and the table of a
+    //! derived class starts with a copy of that of its base class. A lookup is one bounds
+    //! check and one call through the table, with no call up the class hierarchy.
+    //! \note The table reads the Port members of a Node on each lookup, so it stays correct
+    //! when a Node replaces a Port, for example in readFromStream().
+    template<std::size_t N>
+    class PortTable
+    {
+    public:
+        //! Declare the Ports of a class whose base class has none.
+        template<typename... Entries>
+        constexpr explicit PortTable(const PortEntry& first, const Entries&... rest)
+            :
+            _entries{{first, rest...}}
+        {
+            static_assert(1 + sizeof...(Entries) == N, "Every Port of the class must be in the table");
+        }
+
+        //! Declare the Ports of a class after those of its base class.
+        template<std::size_t K, typename... Entries>
+        constexpr PortTable(const PortTable<K>& base, const Entries&... entries)
+        {
+            static_assert(K + sizeof...(Entries) == N, "Every Port of the class must be in the table");
+            std::size_t next = 0;
+            for (const auto& entry : base)
+            {
+                _entries[next++] = entry;
+            }
+            ((_entries[next++] = entries), ...);
+        }
+
+        static constexpr std::size_t size()
+        {
+            return N;
+        }
+
+        //! \return The Port at index of node, or nullptr past the end.
+        //! \pre node is an instance of the class that declares the table, or of a class derived from it.
+        [[nodiscard]]dagbase::Port* port(const dagbase::Node& node, std::size_t index) const
+        {
+            return index < N ? _entries[index].port(node) : nullptr;
+        }
+
+        //! \return The MetaPort at index, or nullptr past the end.
+        [[nodiscard]]dagbase::MetaPort* metaPort(std::size_t index) const
+        {
+            return index < N ? _entries[index].metaPort : nullptr;
+        }
+
+        [[nodiscard]]constexpr auto begin() const
+        {
+            return _entries.begin();
+        }
+
+        [[nodiscard]]constexpr auto end() const
+        {
+            return _entries.end();
+        }
+    private:
+        std::array<PortEntry, N> _entries{};
+    };
+
+    //! Implements the Port lookups of dagbase::Node from NodeClass::portTable.
+    //! NodeClass derives from PortTableNode<NodeClass, Parent> in place of Parent, and
+    //! declares its table after those of Parent:
+    //! \code
+    //! class Derived : public PortTableNode<Derived, Base>
+    //! {
+    //! public:
+    //!     static const PortTable<2> portTable;
+    //! };
+    //!
+    //! const PortTable<2> Derived::portTable(Base::portTable, declarePort<&Derived::_trigger>(ports[0]));
+    //! \endcode
+    template<typename NodeClass, typename Parent = dagbase::Node>
+    class PortTableNode : public Parent
+    {
+    public:
+        using Parent::Parent;
+
+        [[nodiscard]]size_t totalPorts() const override
+        {
+            return NodeClass::portTable.size();
+        }
+
+        [[nodiscard]]dagbase::Port* dynamicPort(size_t index) override
+        {
+            return NodeClass::portTable.port(*this, index);
+        }
+
+        [[nodiscard]]const dagbase::Port* dynamicPort(size_t index) const override
+        {
+            return NodeClass::portTable.port(*this, index);
+        }
+
+        [[nodiscard]]const dagbase::MetaPort* dynamicMetaPort(size_t index) const override
+        {
+            return NodeClass::portTable.metaPort(index);
+        }
+
+        [[nodiscard]]dagbase::MetaPort* dynamicMetaPort(size_t index) override
+        {
+            return NodeClass::portTable.metaPort(index);
+        }
+    protected:
+        PortTableNode() = default;
+    };
+}
@@ -11,46 +11,50 @@
 #include "io/OutputStream.h"
 #include "core/Transfer.h"
 #include "core/Types.h"
+#include "DirtyTracker.h"
+
+#include <string>
+#include <type_traits>
 
 namespace dag
 {
     template <typename T>
-    class PrimitivePort : public Port
+    class PrimitivePort : public dagbase::Port, public ChangeCounter
     {
     public:
         using Writer = dagbase::OutputStream & (dagbase::OutputStream::*)(T);
         using Reader = dagbase::InputStream& (dagbase::InputStream::*)(T*) const;
     public:
 		static_assert(std::is_convertible_v<T, std::string> || std::is_integral_v<T> || std::is_convertible_v<T, bool> || std::is_floating_point_v<T>);
-        PrimitivePort(PortID id, std::string name, PortType::Type type, PortDirection::Direction dir, T value, Node* parent = nullptr, std::uint32_t flags=0x0)
+        PrimitivePort(dagbase::PortID id, std::string name, dagbase::PortType::Type type, dagbase::PortDirection::Direction dir, T value, dagbase::Node* parent = nullptr, std::uint32_t flags=0x0)
         :
-        Port(id, parent, new MetaPort(std::move(name), type, dir), flags|Port::OWN_META_PORT_BIT),
+        dagbase::Port(id, parent, new dagbase::MetaPort(std::move(name), type, dir), flags|dagbase::Port::OWN_META_PORT_BIT),
         _value(value)
         {
             setOwnMetaPort(true);
         }
 
-		PrimitivePort(PortID id, Node* parent, MetaPort* metaPort, T value, std::uint32_t flags=0x0)
+		PrimitivePort(dagbase::PortID id, dagbase::Node* parent, dagbase::MetaPort* metaPort, T value, std::uint32_t flags=0x0)
 			:
-			Port(id, parent, metaPort, flags),
+			dagbase::Port(id, parent, metaPort, flags),
 			_value(value)
 		{
 			// Do nothing.
 		}
 
-        PrimitivePort(const PrimitivePort& other, CloningFacility& facility, CopyOp copyOp, KeyGenerator* keyGen)
+        PrimitivePort(const PrimitivePort& other, dagbase::CloningFacility& facility, dagbase::CopyOp copyOp, dagbase::KeyGenerator* keyGen)
         :
-        Port(other, facility, copyOp, keyGen)
+        dagbase::Port(other, facility, copyOp, keyGen)
         {
             _value = other._value;
         }
 
-        explicit PrimitivePort(dagbase::InputStream& str, NodeLibrary& nodeLib, dagbase::Lua& lua)
+        explicit PrimitivePort(dagbase::InputStream& str, dagbase::NodeLibrary& nodeLib, dagbase::Lua& lua)
         {
         	std::string className;
         	std::string fieldName;
         	str.readHeader(&className);
-        	Port::readFromStream(str, nodeLib, lua);
+        	dagbase::Port::readFromStream(str, nodeLib, lua);
         	str.readField(&fieldName);
         	dagbase::Variant configValue(_value);
             str.read(lua, &configValue);
@@ -67,16 +71,16 @@ namespace dag
 
             switch(type())
             {
-                case PortType::TYPE_INT64:
+                case dagbase::PortType::TYPE_INT64:
                     className = "PrimitivePort<int64_t>";
                     break;
-                case PortType::TYPE_DOUBLE:
+                case dagbase::PortType::TYPE_DOUBLE:
                     className = "PrimitivePort<double>";
                     break;
-                case PortType::TYPE_STRING:
+                case dagbase::PortType::TYPE_STRING:
                     className = "PrimitivePort<string>";
                     break;
-                case PortType::TYPE_BOOL:
+                case dagbase::PortType::TYPE_BOOL:
                     className = "PrimitivePort<bool>";
                     break;
                 default:
@@ -86,7 +90,7 @@ namespace dag
         	str.writeField("className");
         	str.writeString(className, true);
         	str.writeHeader(className);
-            Port::write(str);
+            dagbase::Port::write(str);
         	str.writeField("value");
         	str.write(dagbase::ConfigurationElement::ValueType(_value));
         	str.writeFooter();
@@ -94,14 +98,19 @@ namespace dag
             return str;
         }
 
-        PrimitivePort* clone(CloningFacility& facility, CopyOp copyOp, KeyGenerator* keyGen) override
+        PrimitivePort* clone(dagbase::CloningFacility& facility, dagbase::CopyOp copyOp, dagbase::KeyGenerator* keyGen) override
         {
             return new PrimitivePort(*this, facility, copyOp, keyGen);
         }
 
+		//! Set the value, counting a change so that an EvaluationPlan sees it in evaluateDirty().
 		void setValue(T value)
 		{
-			_value = value;
+			if (_value != value)
+			{
+				_value = value;
+				changed();
+			}
 		}
 
 		T value() const
@@ -109,11 +118,11 @@ namespace dag
 			return _value;
 		}
 
-        Transfer* connectTo(Port& dest) override
+        dagbase::Transfer* connectTo(dagbase::Port& dest) override
         {
-			if (dir() == PortDirection::DIR_OUT && dest.dir() == PortDirection::DIR_IN && isCompatibleWith(dest))
+			if (dir() == dagbase::PortDirection::DIR_OUT && dest.dir() == dagbase::PortDirection::DIR_IN && isCompatibleWith(dest))
 			{
-				auto transfer = new TypedTransfer(&_value);
+				auto transfer = new dagbase::TypedTransfer<T>(&_value);
 				dest.setDestination(transfer);
 
 				addOutgoingConnection(&dest);
@@ -125,9 +134,9 @@ namespace dag
 			return nullptr;
         }
 
-		Transfer* setDestination(Transfer* transfer) override
+		dagbase::Transfer* setDestination(dagbase::Transfer* transfer) override
 		{
-			auto typedTransfer = dynamic_cast<TypedTransfer<T>*>(transfer);
+			auto typedTransfer = dynamic_cast<dagbase::TypedTransfer<T>*>(transfer);
 
 			if (typedTransfer != nullptr)
 			{
@@ -137,19 +146,19 @@ namespace dag
 			return transfer;
 		}
 
-        void accept(ValueVisitor& visitor) override
+        void accept(dagbase::ValueVisitor& visitor) override
         {
             visitor.setValue(_value);
         }
 
-        void accept(SetValueVisitor& visitor) override
+        void accept(dagbase::SetValueVisitor& visitor) override
         {
-            _value = visitor.value().operator T();
+            setValue(visitor.value().operator T());
         }
 
-        [[nodiscard]]bool equals(const Port& other) const override
+        [[nodiscard]]bool equals(const dagbase::Port& other) const override
         {
-            if (!Port::operator==(other))
+            if (!dagbase::Port::operator==(other))
             {
                 return false;
             }
@@ -164,14 +173,10 @@ namespace dag
             return true;
         }
 
-        void debug(dagbase::DebugPrinter& printer) const override;
-
         [[nodiscard]]const char* className() const override
         {
-            return PortType::toString(type());
+            return dagbase::PortType::toString(type());
         }
-
-        std::ostream& toLua(std::ostream& str) override;
     private:
 		T _value;
 	};
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "config/Export.h"
+
+#include "core/Types.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace dag
+{
+    class EvaluationPlan;
+
+    //! The divisors of the Nodes of an EvaluationPlan and the tick that decides which of them are due.
+    //! A Node with divisor d runs only on the frames whose tick is a multiple of d.
+    //! The Nodes are bucketed by divisor when compiled, so that finding the Nodes due in a frame
+    //! costs in proportion to their number rather than to the number of Nodes.
+    class DAG_API RateSchedule
+    {
+    public:
+        typedef std::vector<std::uint32_t> IndexArray;
+    public:
+        //! Run the Node with the given id only on every divisor-th frame.
+        //! \param divisor One or zero to run the Node on every frame.
+        void setDivisor(dagbase::NodeID id, std::uint32_t divisor);
+
+        //! Bucket the Nodes of plan by divisor.
+        void compile(const EvaluationPlan& plan);
+
+        //! Decide the Nodes that are due this frame, see dueNodes().
+        void beginFrame();
+
+        //! Advance the tick, the only place it changes.
+        void endFrame()
+        {
+            ++_tick;
+        }
+
+        //! \return true if the Node at index runs this frame, see beginFrame().
+        [[nodiscard]]bool isDue(std::size_t index) const
+        {
+            return _rateOf.empty() || _rateOf[index] == NO_RATE || _rateDue[_rateOf[index]] != 0;
+        }
+
+        //! \return true if the Node at index has a divisor above one.
+        [[nodiscard]]bool hasDivisor(std::size_t index) const
+        {
+            return !_rateOf.empty() && _rateOf[index] != NO_RATE;
+        }
+
+        //! \return true if some Node has a divisor above one, so that dueNodes() applies.
+        [[nodiscard]]bool hasRates() const
+        {
+            return !_rates.empty();
+        }
+
+        //! \return The indices of the Nodes due this frame in plan order.
+        //! \pre hasRates(), otherwise every Node is due.
+        [[nodiscard]]const IndexArray& dueNodes() const
+        {
+            return _due;
+        }
+
+        [[nodiscard]]std::uint64_t tick() const
+        {
+            return _tick;
+        }
+
+        //! \return The number of distinct divisors above one.
+        [[nodiscard]]std::size_t numRates() const
+        {
+            return _rates.size();
+        }
+
+        //! \return The number of Nodes due this frame.
+        [[nodiscard]]std::uint32_t numDue() const
+        {
+            return _rates.empty() ? _numNodes : std::uint32_t(_due.size());
+        }
+    private:
+        //! The rate of a Node that runs on every tick
+        static constexpr std::uint32_t NO_RATE = ~std::uint32_t{0};
+
+        struct RateSetting
+        {
+            dagbase::NodeID node;
+            std::uint32_t divisor{1};
+        };
+        std::vector<RateSetting> _settings;
+        //! The distinct divisors above one in increasing order
+        std::vector<std::uint32_t> _rates;
+        //! Per rate, the Nodes with that divisor in plan order
+        std::vector<IndexArray> _nodesOfRate;
+        //! The Nodes without a divisor in plan order
+        IndexArray _everyTick;
+        //! Per Node, the index of its divisor in _rates or NO_RATE. Empty when there are no rates.
+        IndexArray _rateOf;
+        //! Per rate, 1 if it is due this frame
+        std::vector<std::uint8_t> _rateDue;
+        //! The Nodes due this frame, merged from the buckets of the due rates
+        IndexArray _due;
+        IndexArray _merged;
+        std::uint64_t _tick{0};
+        std::uint32_t _numNodes{0};
+    };
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "config/Export.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace dag
+{
+    //! A fixed set of worker threads that run a loop body over an index range.
+    //! The calling thread takes part in the work and parallelFor() does not return
+    //! until every index has been processed, so each call acts as a barrier.
+    class DAG_API ThreadPool
+    {
+    public:
+        //! \param numThreads The total number of threads including the caller, zero means one per hardware thread.
+        explicit ThreadPool(std::size_t numThreads);
+
+        ThreadPool(const ThreadPool&) = delete;
+
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        ~ThreadPool();
+
+        //! \return The number of threads that share the work, including the caller.
+        [[nodiscard]]std::size_t numThreads() const
+        {
+            return _workers.size() + 1;
+        }
+
+        //! Call f(i) for each i in [0, count) and wait for all of them to finish.
+        //! \note f is called concurrently so it must not write to shared state without synchronisation.
+        template<typename F>
+        void parallelFor(std::size_t count, F& f)
+        {
+            run(count, &invoke<F>, &f);
+        }
+    private:
+        using Task = void (*)(void* context, std::size_t index);
+
+        template<typename F>
+        static void invoke(void* context, std::size_t index)
+        {
+            (*static_cast<F*>(context))(index);
+        }
+
+        void run(std::size_t count, Task task, void* context);
+
+        void workerLoop();
+
+        void drain();
+
+        std::vector<std::thread> _workers;
+        std::mutex _mutex;
+        std::condition_variable _start;
+        std::condition_variable _done;
+        Task _task{nullptr};
+        void* _context{nullptr};
+        std::size_t _count{0};
+        std::size_t _grain{1};
+        std::atomic<std::size_t> _next{0};
+        std::size_t _busy{0};
+        std::uint64_t _generation{0};
+        bool _stop{false};
+    };
+}
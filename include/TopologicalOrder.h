@@ -0,0 +1,102 @@
+#pragma once
+
+#include "config/Export.h"
+
+#include "core/Types.h"
+#include "core/Variant.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace dagbase
+{
+    class Graph;
+    class Node;
+    class Port;
+}
+
+namespace dag
+{
+    //! A topological order of the Nodes of a Graph that is kept up to date one edit at a time.
+    //! New connections reorder only the Nodes between the two ends (Pearce and Kelly),
+    //! which also detects the connections that would close a cycle.
+    //! Connections into a Delay are feedback edges and place no constraint on the order.
+    //! The Nodes of child Graphs are ordered with those of the root Graph. A Port that a
+    //! GraphNode shares with a Boundary belongs to the Boundary, so edges run through the
+    //! child Graph and the GraphNode itself has none.
+    class DAG_API TopologicalOrder
+    {
+    public:
+        TopologicalOrder() = default;
+
+        //! Replace the order with a full sort of graph and its child Graphs.
+        //! isValid() is false afterwards if they have a cycle that does not pass through a Delay.
+        void rebuild(dagbase::Graph& graph);
+
+        //! Forget the order, typically after an edit that is not tracked.
+        void invalidate()
+        {
+            _valid = false;
+        }
+
+        [[nodiscard]]bool isValid() const
+        {
+            return _valid;
+        }
+
+        //! Append a Node that has no connections yet.
+        //! \note A GraphNode whose Graph already has Nodes invalidates the order.
+        void addNode(dagbase::Node* node);
+
+        //! \note Removing a GraphNode or a Boundary invalidates the order.
+        void removeNode(const dagbase::Node* node);
+
+        //! Reorder for a connection from one Port to another, before it is made.
+        //! \note A removed connection never invalidates the order, so there is no removeEdge().
+        //! \retval false The connection would close a cycle, the order is unchanged.
+        bool addEdge(const dagbase::Port& from, const dagbase::Port& to);
+
+        //! Append the Nodes to nodes in topological order.
+        //! \pre isValid()
+        void sorted(dagbase::NodeArray* nodes) const;
+
+        [[nodiscard]]std::size_t numNodes() const
+        {
+            return _rank.size();
+        }
+
+        dagbase::Variant find(std::string_view path) const;
+    private:
+        typedef std::vector<dagbase::Node*> NodeArray;
+
+        //! Append the Nodes of graph and of its child Graphs to nodes, and find the Boundary of each shared Port.
+        void collect(dagbase::Graph& graph, NodeArray& nodes);
+
+        //! Sort nodes with Kahn's algorithm, ignoring feedback edges and connections from outside nodes.
+        //! \retval false A cycle remains without passing through a Delay.
+        bool sortWithFeedback(const NodeArray& nodes, dagbase::NodeArray& sorted) const;
+
+        //! \return The Boundary of a Port shared with a GraphNode, otherwise the parent of port.
+        [[nodiscard]]dagbase::Node* owner(const dagbase::Port* port) const;
+
+        //! Collect the Nodes reachable from start whose rank is in [lower, upper].
+        //! \retval false stop was reached.
+        bool visit(dagbase::Node* start, std::size_t lower, std::size_t upper, bool forward, const dagbase::Node* stop, NodeArray& visited);
+
+        void compact();
+
+        //! Indexed by rank, removed Nodes leave a nullptr until the next compact().
+        NodeArray _order;
+        std::unordered_map<const dagbase::Node*, std::size_t> _rank;
+        //! The Ports of every Boundary, which a GraphNode may share.
+        std::unordered_map<const dagbase::Port*, dagbase::Node*> _boundaryOf;
+        NodeArray _stack;
+        std::size_t _numHoles{0};
+        std::uint32_t _numRebuilds{0};
+        std::uint32_t _numReordered{0};
+        bool _valid{true};
+    };
+}
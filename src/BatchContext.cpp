@@ -0,0 +1,126 @@
+#include "config/config.h"
+
+#include "BatchContext.h"
+#include "core/Port.h"
+#include "core/TypedPort.h"
+
+#include <algorithm>
+#include <new>
+
+namespace dag
+{
+    namespace
+    {
+        template<typename T>
+        T currentValue(const dagbase::Port& port)
+        {
+            if (auto typed = dynamic_cast<const dagbase::TypedPort<T>*>(&port))
+            {
+                return typed->value();
+            }
+
+            dagbase::ValueVisitor getter;
+            const_cast<dagbase::Port&>(port).accept(getter);
+
+            return getter.value().operator T();
+        }
+    }
+
+    BatchContext::~BatchContext()
+    {
+        ::operator delete(_block, std::align_val_t(alignment));
+    }
+
+    void BatchContext::reset(std::size_t size)
+    {
+        _slots.clear();
+        _numAliases = 0;
+        _size = size;
+        _committed = false;
+    }
+
+    void BatchContext::addPort(const dagbase::Port& port)
+    {
+        const auto type = port.type();
+
+        if (type != dagbase::PortType::TYPE_DOUBLE && type != dagbase::PortType::TYPE_INT64)
+        {
+            return;
+        }
+
+        Slot slot;
+        slot.type = type;
+        _slots.emplace(&port, slot);
+    }
+
+    bool BatchContext::alias(const dagbase::Port& dest, const dagbase::Port& source)
+    {
+        auto destIt = _slots.find(&dest);
+        auto sourceIt = _slots.find(&source);
+
+        if (_committed || destIt == _slots.end() || sourceIt == _slots.end() || &dest == &source || destIt->second.type != sourceIt->second.type || destIt->second.alias != nullptr)
+        {
+            return false;
+        }
+
+        destIt->second.alias = &source;
+        ++_numAliases;
+
+        return true;
+    }
+
+    void BatchContext::commit()
+    {
+        static_assert(sizeof(double) == sizeof(std::int64_t));
+
+        // Round each array up to whole cache lines so that every array is aligned.
+        _stride = (std::max(_size, std::size_t{1}) * sizeof(double) + alignment - 1) / alignment * alignment;
+        ::operator delete(_block, std::align_val_t(alignment));
+        _block = static_cast<unsigned char*>(::operator new(_stride * (_slots.size() - _numAliases), std::align_val_t(alignment)));
+
+        std::size_t offset = 0;
+        for (auto& [port, slot] : _slots)
+        {
+            if (slot.alias != nullptr)
+            {
+                continue;
+            }
+            slot.offset = offset;
+            offset += _stride;
+            if (slot.type == dagbase::PortType::TYPE_DOUBLE)
+            {
+                auto values = reinterpret_cast<double*>(_block + slot.offset);
+                std::fill(values, values + _size, currentValue<double>(*port));
+            }
+            else
+            {
+                auto values = reinterpret_cast<std::int64_t*>(_block + slot.offset);
+                std::fill(values, values + _size, currentValue<std::int64_t>(*port));
+            }
+        }
+
+        // Aliases may form chains, so follow each one to the Port that owns the array.
+        for (auto& [port, slot] : _slots)
+        {
+            const Slot* owner = &slot;
+            for (std::size_t hops=0; owner->alias != nullptr && hops<_slots.size(); ++hops)
+            {
+                owner = &_slots.at(owner->alias);
+            }
+            slot.offset = owner->offset;
+        }
+        _committed = true;
+    }
+
+    void* BatchContext::data(const dagbase::Port& port, dagbase::PortType::Type type) const
+    {
+        auto it = _slots.find(&port);
+
+        if (!_committed || it == _slots.end() || it->second.type != type)
+        {
+            return nullptr;
+        }
+
+        return _block + it->second.offset;
+    }
+}
@@ -0,0 +1,255 @@
+#include "config/config.h"
+
+#include "BatchPlan.h"
+#include "BatchContext.h"
+#include "EvaluationPlan.h"
+#include "core/Node.h"
+#include "core/Port.h"
+#include "core/TypedPort.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace dag
+{
+    namespace
+    {
+        template<typename T>
+        bool isTyped(const dagbase::Port& port)
+        {
+            return dynamic_cast<const dagbase::TypedPort<T>*>(&port) != nullptr;
+        }
+
+        template<typename T>
+        T loadSample(dagbase::Port* port, bool typed)
+        {
+            if (typed)
+            {
+                return static_cast<dagbase::TypedPort<T>*>(port)->value();
+            }
+
+            dagbase::ValueVisitor getter;
+            port->accept(getter);
+
+            return getter.value().operator T();
+        }
+
+        template<typename T>
+        void storeSample(dagbase::Port* port, bool typed, T value)
+        {
+            if (typed)
+            {
+                static_cast<dagbase::TypedPort<T>*>(port)->setValue(value);
+            }
+            else
+            {
+                dagbase::SetValueVisitor setter{dagbase::Value(value)};
+                port->accept(setter);
+            }
+        }
+
+        template<typename From, typename To>
+        void convertSamples(const void* source, void* dest, std::size_t n)
+        {
+            auto from = static_cast<const From*>(source);
+            auto to = static_cast<To*>(dest);
+
+            for (std::size_t i=0; i<n; ++i)
+            {
+                to[i] = static_cast<To>(from[i]);
+            }
+        }
+    }
+
+    void BatchPlan::prepare(const EvaluationPlan& plan, BatchContext& context, std::size_t n)
+    {
+        context.reset(n);
+        for (std::size_t i=0; i<plan.numNodes(); ++i)
+        {
+            auto node = plan.node(i);
+
+            for (std::size_t portIndex=0; portIndex<node->totalPorts(); ++portIndex)
+            {
+                if (auto port = node->dynamicPort(portIndex))
+                {
+                    context.addPort(*port);
+                }
+            }
+        }
+
+        _transfers.assign(plan.numTransfers(), BatchTransfer());
+        _numAliased = 0;
+        if (_zeroCopy)
+        {
+            for (std::size_t t=0; t<plan.numTransfers(); ++t)
+            {
+                _transfers[t].aliased = context.alias(*plan.transfer(t).dest, *plan.transfer(t).source);
+                _numAliased += _transfers[t].aliased ? 1 : 0;
+            }
+        }
+        context.commit();
+
+        for (std::size_t t=0; t<plan.numTransfers(); ++t)
+        {
+            auto& batchTransfer = _transfers[t];
+            const auto& transfer = plan.transfer(t);
+
+            batchTransfer.sourceType = transfer.source->type();
+            batchTransfer.destType = transfer.dest->type();
+            batchTransfer.source = context.data(*transfer.source, batchTransfer.sourceType);
+            batchTransfer.dest = context.data(*transfer.dest, batchTransfer.destType);
+        }
+
+        _batchNodes.resize(plan.numNodes());
+        _firstPort.clear();
+        _ports.clear();
+        for (std::size_t i=0; i<plan.numNodes(); ++i)
+        {
+            auto node = plan.node(i);
+
+            _batchNodes[i] = dynamic_cast<BatchNode*>(node);
+            _firstPort.emplace_back(std::uint32_t(_ports.size()));
+            if (_batchNodes[i] != nullptr)
+            {
+                continue;
+            }
+
+            for (std::size_t portIndex=0; portIndex<node->totalPorts(); ++portIndex)
+            {
+                auto port = node->dynamicPort(portIndex);
+                if (port == nullptr)
+                {
+                    continue;
+                }
+
+                BatchPort batchPort;
+                batchPort.port = port;
+                batchPort.type = port->type();
+                batchPort.data = context.data(*port, batchPort.type);
+                batchPort.isOutput = port->dir() == dagbase::PortDirection::DIR_OUT;
+                batchPort.isTyped = batchPort.type == dagbase::PortType::TYPE_DOUBLE ? isTyped<double>(*port) : isTyped<std::int64_t>(*port);
+                if (batchPort.data != nullptr)
+                {
+                    _ports.emplace_back(batchPort);
+                }
+            }
+        }
+        _firstPort.emplace_back(std::uint32_t(_ports.size()));
+        _context = &context;
+    }
+
+    void BatchPlan::transfer(const EvaluationPlan& plan, std::size_t index, std::size_t n) const
+    {
+        const auto& batchTransfer = _transfers[index];
+
+        if (batchTransfer.aliased)
+        {
+            return;
+        }
+
+        if (batchTransfer.source != nullptr && batchTransfer.dest != nullptr)
+        {
+            if (batchTransfer.sourceType == batchTransfer.destType)
+            {
+                std::memcpy(batchTransfer.dest, batchTransfer.source, n * sizeof(double));
+            }
+            else if (batchTransfer.sourceType == dagbase::PortType::TYPE_DOUBLE)
+            {
+                convertSamples<double, std::int64_t>(batchTransfer.source, batchTransfer.dest, n);
+            }
+            else
+            {
+                convertSamples<std::int64_t, double>(batchTransfer.source, batchTransfer.dest, n);
+            }
+
+            return;
+        }
+
+        // At least one end is a single value, so copy it once and spread it over the samples.
+        plan.transfer(index).makeItSo();
+        if (batchTransfer.dest != nullptr)
+        {
+            auto dest = plan.transfer(index).dest;
+            if (batchTransfer.destType == dagbase::PortType::TYPE_DOUBLE)
+            {
+                auto values = static_cast<double*>(batchTransfer.dest);
+                std::fill(values, values + n, loadSample<double>(dest, isTyped<double>(*dest)));
+            }
+            else
+            {
+                auto values = static_cast<std::int64_t*>(batchTransfer.dest);
+                std::fill(values, values + n, loadSample<std::int64_t>(dest, isTyped<std::int64_t>(*dest)));
+            }
+        }
+    }
+
+    void BatchPlan::updateSamples(const EvaluationPlan& plan, std::size_t index, std::size_t n) const
+    {
+        const auto begin = _ports.begin() + _firstPort[index];
+        const auto end = _ports.begin() + _firstPort[index + 1];
+
+        for (std::size_t sample=0; sample<n; ++sample)
+        {
+            for (auto it = begin; it != end; ++it)
+            {
+                if (it->isOutput)
+                {
+                    continue;
+                }
+                if (it->type == dagbase::PortType::TYPE_DOUBLE)
+                {
+                    storeSample(it->port, it->isTyped, static_cast<const double*>(it->data)[sample]);
+                }
+                else
+                {
+                    storeSample(it->port, it->isTyped, static_cast<const std::int64_t*>(it->data)[sample]);
+                }
+            }
+
+            plan.node(index)->update();
+
+            for (auto it = begin; it != end; ++it)
+            {
+                if (!it->isOutput)
+                {
+                    continue;
+                }
+                if (it->type == dagbase::PortType::TYPE_DOUBLE)
+                {
+                    static_cast<double*>(it->data)[sample] = loadSample<double>(it->port, it->isTyped);
+                }
+                else
+                {
+                    static_cast<std::int64_t*>(it->data)[sample] = loadSample<std::int64_t>(it->port, it->isTyped);
+                }
+            }
+        }
+    }
+
+    void BatchPlan::evaluate(const EvaluationPlan& plan) const
+    {
+        const std::size_t n = _context->size();
+
+        for (std::size_t i=0; i<plan.numNodes(); ++i)
+        {
+            if (!plan.isLive(i))
+            {
+                continue;
+            }
+
+            for (std::uint32_t t=plan.beginTransfer(i); t<plan.endTransfer(i); ++t)
+            {
+                transfer(plan, t, n);
+            }
+
+            if (_batchNodes[i] != nullptr)
+            {
+                _batchNodes[i]->updateBatch(*_context, n);
+            }
+            else
+            {
+                updateSamples(plan, i, n);
+            }
+        }
+    }
+}
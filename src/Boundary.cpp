@@ -86,6 +86,82 @@ namespace dag
         }
     }
 
+    dagbase::Port* Boundary::partner(const dagbase::Port& port) const
+    {
+        const auto dir = port.dir();
+        if (dir != dagbase::PortDirection::DIR_IN && dir != dagbase::PortDirection::DIR_OUT)
+        {
+            return nullptr;
+        }
+
+        const auto otherDir = dir == dagbase::PortDirection::DIR_IN ? dagbase::PortDirection::DIR_OUT : dagbase::PortDirection::DIR_IN;
+        std::size_t rank = 0;
+        bool found = false;
+        for (auto p : _dynamicPorts)
+        {
+            if (p == &port)
+            {
+                found = true;
+                break;
+            }
+            if (p->dir() == dir)
+            {
+                ++rank;
+            }
+        }
+
+        if (!found)
+        {
+            return nullptr;
+        }
+
+        for (auto p : _dynamicPorts)
+        {
+            if (p->dir() == otherDir)
+            {
+                if (rank == 0)
+                {
+                    return p;
+                }
+                --rank;
+            }
+        }
+
+        return nullptr;
+    }
+
+    void Boundary::update()
+    {
+        const std::size_t n = _dynamicPorts.size();
+        std::size_t out = 0;
+
+        for (std::size_t in=0; in<n; ++in)
+        {
+            auto source = _dynamicPorts.a[in];
+
+            if (source->dir() != dagbase::PortDirection::DIR_IN)
+            {
+                continue;
+            }
+
+            while (out < n && _dynamicPorts.a[out]->dir() != dagbase::PortDirection::DIR_OUT)
+            {
+                ++out;
+            }
+
+            if (out == n)
+            {
+                break;
+            }
+
+            dagbase::ValueVisitor getter;
+            source->accept(getter);
+            dagbase::SetValueVisitor setter(getter.value());
+            _dynamicPorts.a[out]->accept(setter);
+            ++out;
+        }
+    }
+
     void Boundary::debug(dagbase::DebugPrinter& printer) const
     {
         Node::debug(printer);
@@ -0,0 +1,93 @@
+#include "config/config.h"
+
+#include "ChainFusion.h"
+#include "EvaluationPlan.h"
+#include "MathNode.h"
+
+namespace dag
+{
+    void ChainFusion::compile(const EvaluationPlan& plan, const std::vector<std::uint8_t>& fusable, const IndexArray& region)
+    {
+        const std::size_t n = plan.numNodes();
+
+        _chains.clear();
+        _chainOf.clear();
+        _fused.clear();
+        _numFused = 0;
+        if (!_enabled)
+        {
+            return;
+        }
+
+        auto link = [&plan, &fusable](std::size_t index) -> MathsNode*
+        {
+            return fusable[index] ? dynamic_cast<MathsNode*>(plan.node(index)) : nullptr;
+        };
+
+        // Link each MathsNode to the one it alone feeds, at most one consumer per producer.
+        IndexArray next(n, NO_CHAIN);
+        std::vector<std::uint8_t> hasPrevious(n, 0);
+        for (std::size_t i=0; i<n; ++i)
+        {
+            auto node = link(i);
+            if (node == nullptr || plan.endTransfer(i) - plan.beginTransfer(i) != 1)
+            {
+                continue;
+            }
+
+            const auto t = plan.beginTransfer(i);
+            const auto source = plan.sourceNode(t);
+            auto producer = source != EvaluationPlan::NO_NODE ? link(source) : nullptr;
+            if (producer == nullptr || next[source] != NO_CHAIN || region[source] != region[i] ||
+                plan.transfer(t).source != producer->output() || plan.transfer(t).dest != node->angle())
+            {
+                continue;
+            }
+
+            next[source] = std::uint32_t(i);
+            hasPrevious[i] = 1;
+        }
+
+        for (std::size_t i=0; i<n; ++i)
+        {
+            if (hasPrevious[i] || next[i] == NO_CHAIN)
+            {
+                continue;
+            }
+
+            if (_chainOf.empty())
+            {
+                _chainOf.assign(n, NO_CHAIN);
+                _fused.assign(n, 0);
+            }
+
+            Chain chain;
+            for (auto index = std::uint32_t(i); index != NO_CHAIN; index = next[index])
+            {
+                chain.links.emplace_back(static_cast<MathsNode*>(plan.node(index)));
+                chain.nodes.emplace_back(index);
+                if (index != i)
+                {
+                    _fused[index] = 1;
+                    ++_numFused;
+                }
+            }
+            _chainOf[i] = std::uint32_t(_chains.size());
+            _chains.emplace_back(std::move(chain));
+        }
+    }
+
+    void ChainFusion::run(std::uint32_t chain) const
+    {
+        const auto& links = _chains[chain].links;
+
+        double value = links.front()->apply(links.front()->angle()->value());
+        links.front()->output()->setValue(value);
+        for (std::size_t link=1; link<links.size(); ++link)
+        {
+            links[link]->angle()->setValue(value);
+            value = links[link]->apply(value);
+            links[link]->output()->setValue(value);
+        }
+    }
+}
@@ -0,0 +1,44 @@
+#include "config/config.h"
+
+#include "ConeCache.h"
+#include "EvaluationPlan.h"
+
+#include <algorithm>
+
+namespace dag
+{
+    const ConeCache::IndexArray& ConeCache::coneFor(const EvaluationPlan& plan, std::uint32_t index)
+    {
+        auto it = _cones.find(index);
+        if (it != _cones.end())
+        {
+            return it->second;
+        }
+
+        IndexArray cone;
+        std::vector<bool> visited(plan.numNodes(), false);
+        IndexArray stack{index};
+
+        visited[index] = true;
+        while (!stack.empty())
+        {
+            const auto current = stack.back();
+            stack.pop_back();
+            cone.emplace_back(current);
+            for (std::uint32_t t=plan.beginTransfer(current); t<plan.endTransfer(current); ++t)
+            {
+                const auto source = plan.sourceNode(t);
+
+                if (source != EvaluationPlan::NO_NODE && !visited[source])
+                {
+                    visited[source] = true;
+                    stack.emplace_back(source);
+                }
+            }
+        }
+        // Ascending plan order is topological.
+        std::sort(cone.begin(), cone.end());
+
+        return _cones.emplace(index, std::move(cone)).first->second;
+    }
+}
@@ -0,0 +1,87 @@
+#include "config/config.h"
+
+#include "ConstantFolding.h"
+#include "EvaluationPlan.h"
+#include "core/Node.h"
+
+#include <vector>
+
+namespace dag
+{
+    void ConstantFolding::compile(const EvaluationPlan& plan)
+    {
+        const std::size_t n = plan.numNodes();
+
+        _folded.assign(n, 0);
+        _current.assign(n, 0);
+        _numFolded = 0;
+        if (!_enabled)
+        {
+            return;
+        }
+
+        // Producers come first, so one pass in order sees every producer before its consumers.
+        for (std::size_t i=0; i<n; ++i)
+        {
+            if (plan.node(i)->category() == dagbase::NodeCategory::CAT_SOURCE)
+            {
+                continue;
+            }
+
+            bool constant = true;
+            for (std::uint32_t t=plan.beginTransfer(i); t<plan.endTransfer(i) && constant; ++t)
+            {
+                const auto source = plan.sourceNode(t);
+
+                constant = source == EvaluationPlan::NO_NODE || _folded[source] != 0;
+            }
+
+            if (constant)
+            {
+                _folded[i] = 1;
+                ++_numFolded;
+            }
+        }
+    }
+
+    void ConstantFolding::markUpdated(const EvaluationPlan& plan, std::size_t index) const
+    {
+        if (_folded[index] == 0)
+        {
+            return;
+        }
+
+        for (std::uint32_t t=plan.beginTransfer(index); t<plan.endTransfer(index); ++t)
+        {
+            const auto source = plan.sourceNode(t);
+
+            if (source != EvaluationPlan::NO_NODE && _current[source] == 0)
+            {
+                return;
+            }
+        }
+        _current[index] = 1;
+    }
+
+    void ConstantFolding::unfold(const EvaluationPlan& plan, std::uint32_t index)
+    {
+        std::vector<std::uint32_t> stack{index};
+
+        _current[index] = 0;
+        while (!stack.empty())
+        {
+            const auto current = stack.back();
+            stack.pop_back();
+            for (auto successor = plan.beginSuccessors(current); successor != plan.endSuccessors(current); ++successor)
+            {
+                // Other consumers are updated in every frame anyway. A constant Node that is not
+                // up to date has its constant consumers out of date too, see markUpdated().
+                if (_folded[*successor] != 0 && _current[*successor] != 0)
+                {
+                    _current[*successor] = 0;
+                    stack.emplace_back(*successor);
+                }
+            }
+        }
+    }
+}
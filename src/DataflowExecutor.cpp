@@ -0,0 +1,245 @@
+#include "config/config.h"
+
+#include "DataflowExecutor.h"
+#include "EvaluationPlan.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+namespace dag
+{
+    void DataflowExecutor::prepare(const EvaluationPlan& plan, std::size_t numWorkers)
+    {
+        const std::size_t n = plan.numNodes();
+
+        if (n != _numNodes)
+        {
+            _counts.reset(new std::atomic<std::uint32_t>[n]);
+            _numNodes = n;
+            _numWorkers = 0;
+        }
+
+        if (numWorkers != _numWorkers)
+        {
+            _queues.reset(new WorkQueue[numWorkers]);
+            _numWorkers = numWorkers;
+            for (std::size_t w=0; w<_numWorkers; ++w)
+            {
+                _queues[w].items.reset(new std::atomic<std::uint32_t>[n]);
+            }
+        }
+
+        for (std::size_t w=0; w<_numWorkers; ++w)
+        {
+            _queues[w].top.store(0, std::memory_order_relaxed);
+            _queues[w].bottom.store(0, std::memory_order_relaxed);
+        }
+
+        _pathLength = _criticalPathFirst ? plan.pathLengths() : nullptr;
+
+        // Deal the Nodes without producers round-robin so that every worker starts busy.
+        _sources.clear();
+        for (std::size_t i=0; i<n; ++i)
+        {
+            const auto numPredecessors = plan.numPredecessors(i);
+
+            _counts[i].store(numPredecessors, std::memory_order_relaxed);
+            if (numPredecessors == 0)
+            {
+                _sources.emplace_back(std::uint32_t(i));
+            }
+        }
+        if (_pathLength != nullptr)
+        {
+            // Longest first, so that the start of each critical path goes to a different worker.
+            std::stable_sort(_sources.begin(), _sources.end(), [this](std::uint32_t a, std::uint32_t b)
+            {
+                return shorter(b, a);
+            });
+        }
+        // Each queue is filled in reverse, so that its owner pops its longest source first.
+        for (std::size_t s=_sources.size(); s-- > 0;)
+        {
+            push(s % _numWorkers, _sources[s]);
+        }
+        _remaining.store(n, std::memory_order_relaxed);
+    }
+
+    void DataflowExecutor::evaluate(const EvaluationPlan& plan, ThreadPool& pool)
+    {
+        plan.beginFrame();
+        if (plan.numNodes() != 0)
+        {
+            prepare(plan, pool.numThreads());
+
+            // One index per worker, each of which loops until every Node has run.
+            auto f = [this, &plan](std::size_t worker)
+            {
+                work(plan, worker);
+            };
+            pool.parallelFor(_numWorkers, f);
+        }
+        plan.commitFeedback();
+        plan.endFrame();
+    }
+
+    void DataflowExecutor::work(const EvaluationPlan& plan, std::size_t worker)
+    {
+        std::uint32_t node = 0;
+
+        while (next(worker, node))
+        {
+            run(plan, worker, node);
+        }
+    }
+
+    bool DataflowExecutor::next(std::size_t worker, std::uint32_t& node)
+    {
+        while (_remaining.load(std::memory_order_acquire) > 0)
+        {
+            if (pop(worker, node) || steal(worker, node))
+            {
+                return true;
+            }
+
+            std::unique_lock<std::mutex> lock(_idleMutex);
+            _numSleeping.fetch_add(1, std::memory_order_relaxed);
+            // Pairs with the fence in wake(): either the pusher sees us sleeping or we see its Node.
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const auto epoch = _epoch;
+            const bool found = steal(worker, node);
+            if (!found)
+            {
+                _wakeUp.wait(lock, [this, epoch]
+                {
+                    return _epoch != epoch || _remaining.load(std::memory_order_acquire) == 0;
+                });
+            }
+            _numSleeping.fetch_sub(1, std::memory_order_relaxed);
+            if (found)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void DataflowExecutor::run(const EvaluationPlan& plan, std::size_t worker, std::uint32_t node)
+    {
+        auto& ready = _queues[worker].ready;
+
+        plan.runNode(node);
+        ready.clear();
+        for (auto successor = plan.beginSuccessors(node); successor != plan.endSuccessors(node); ++successor)
+        {
+            if (_counts[*successor].fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                ready.emplace_back(*successor);
+            }
+        }
+        if (_pathLength != nullptr)
+        {
+            // The longest goes last, so that this worker pops it next.
+            std::sort(ready.begin(), ready.end(), [this](std::uint32_t a, std::uint32_t b) { return shorter(a, b); });
+        }
+        for (auto successor : ready)
+        {
+            push(worker, successor);
+        }
+        // This worker runs one of them itself.
+        if (ready.size() > 1)
+        {
+            wake(ready.size() - 1);
+        }
+
+        if (_remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            std::lock_guard<std::mutex> lock(_idleMutex);
+            ++_epoch;
+            _wakeUp.notify_all();
+        }
+    }
+
+    void DataflowExecutor::wake(std::size_t numReady)
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (_numSleeping.load(std::memory_order_relaxed) == 0)
+        {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(_idleMutex);
+        ++_epoch;
+        if (numReady == 1)
+        {
+            _wakeUp.notify_one();
+        }
+        else
+        {
+            _wakeUp.notify_all();
+        }
+    }
+
+    void DataflowExecutor::push(std::size_t worker, std::uint32_t node)
+    {
+        auto& queue = _queues[worker];
+        const auto bottom = queue.bottom.load(std::memory_order_relaxed);
+
+        queue.items[bottom].store(node, std::memory_order_relaxed);
+        queue.bottom.store(bottom + 1, std::memory_order_release);
+    }
+
+    bool DataflowExecutor::pop(std::size_t worker, std::uint32_t& node)
+    {
+        auto& queue = _queues[worker];
+        const auto bottom = queue.bottom.load(std::memory_order_relaxed) - 1;
+
+        queue.bottom.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        auto top = queue.top.load(std::memory_order_relaxed);
+        if (top > bottom)
+        {
+            queue.bottom.store(bottom + 1, std::memory_order_relaxed);
+
+            return false;
+        }
+
+        node = queue.items[bottom].load(std::memory_order_relaxed);
+        if (top == bottom)
+        {
+            // The last item, which a thief may be taking at the same time.
+            const bool won = queue.top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+            queue.bottom.store(bottom + 1, std::memory_order_relaxed);
+
+            return won;
+        }
+
+        return true;
+    }
+
+    bool DataflowExecutor::steal(std::size_t worker, std::uint32_t& node)
+    {
+        for (std::size_t offset=1; offset<_numWorkers; ++offset)
+        {
+            auto& queue = _queues[(worker + offset) % _numWorkers];
+            auto top = queue.top.load(std::memory_order_acquire);
+
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const auto bottom = queue.bottom.load(std::memory_order_acquire);
+            if (top >= bottom)
+            {
+                continue;
+            }
+
+            node = queue.items[top].load(std::memory_order_relaxed);
+            // Losing the race means another worker took it, so try the next queue.
+            if (queue.top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+}
@@ -0,0 +1,131 @@
+#include "config/config.h"
+
+#include "Delay.h"
+#include "io/InputStream.h"
+#include "io/OutputStream.h"
+
+namespace dag
+{
+    std::array<dagbase::MetaPort,2> Delay::ports =
+            {
+                    dagbase::MetaPort{dagbase::MetaPort::FLAGS_OWN_BIT},
+                    dagbase::MetaPort(dagbase::MetaPort::FLAGS_OWN_BIT)
+            };
+
+    bool Delay::equals(const Node &other, dagbase::ComparisonFlags flags) const
+    {
+        if (!Node::equals(other, flags))
+        {
+            return false;
+        }
+
+        auto const & delayOther = dynamic_cast<Delay const&>(other);
+
+        return _input->equals(*delayOther._input, flags) && _output->equals(*delayOther._output, flags);
+    }
+
+    const char *Delay::className() const
+    {
+        return "Delay";
+    }
+
+    const dagbase::MetaPort *Delay::dynamicMetaPort(size_t index) const
+    {
+        if (index < firstPort + numPorts)
+        {
+            return &ports[index - firstPort];
+        }
+
+        return nullptr;
+    }
+
+    dagbase::MetaPort * Delay::dynamicMetaPort(size_t index)
+    {
+        if (index < firstPort + numPorts)
+        {
+            return &ports[index - firstPort];
+        }
+
+        return nullptr;
+    }
+
+    dagbase::Port *Delay::dynamicPort(size_t index)
+    {
+        if (index == firstPort)
+        {
+            return _input;
+        }
+        else if (index == firstPort+1)
+        {
+            return _output;
+        }
+
+        return nullptr;
+    }
+
+    const dagbase::Port * Delay::dynamicPort(size_t index) const
+    {
+        if (index == firstPort)
+        {
+            return _input;
+        }
+        else if (index == firstPort+1)
+        {
+            return _output;
+        }
+
+        return nullptr;
+    }
+
+    dagbase::Node *Delay::create(dagbase::InputStream &str, dagbase::NodeLibrary &nodeLib, dagbase::Lua &lua)
+    {
+        return new Delay(str, nodeLib, lua);
+    }
+
+    Delay::Delay(dagbase::InputStream &str, dagbase::NodeLibrary &nodeLib, dagbase::Lua &lua)
+            :
+            Node(str, nodeLib, lua)
+    {
+        // See MathsNode for why this is a static_cast<>.
+        _input = static_cast<dagbase::TypedPort<double>*>(str.readRef<dagbase::Port>("Port", nodeLib, lua));
+        _output = static_cast<dagbase::TypedPort<double>*>(str.readRef<dagbase::Port>("Port", nodeLib, lua));
+    }
+
+    Delay::Delay(const Delay &other, dagbase::CloningFacility& facility, dagbase::CopyOp copyOp, dagbase::KeyGenerator* keyGen)
+    :
+    Node(other, facility, copyOp, keyGen)
+    {
+        _input = _portStorage.emplace<0>(*other._input, facility, copyOp, keyGen);
+        _input->setParent(this);
+        _output = _portStorage.emplace<1>(*other._output, facility, copyOp, keyGen);
+        _output->setParent(this);
+    }
+
+    dagbase::OutputStream &Delay::writeToStream(dagbase::OutputStream &str, dagbase::NodeLibrary& nodeLib, dagbase::Lua &lua) const
+    {
+        Node::writeToStream(str, nodeLib, lua);
+
+        if (str.writeRef(_input))
+        {
+            _input->writeToStream(str, nodeLib, lua);
+        }
+
+        if (str.writeRef(_output))
+        {
+            _output->writeToStream(str, nodeLib, lua);
+        }
+
+        return str;
+    }
+
+    void Delay::update()
+    {
+        _output->setValue(_input->value());
+    }
+
+    Delay::~Delay()
+    {
+        _portStorage.release(_input);
+        _portStorage.release(_output);
+    }
+}
@@ -0,0 +1,60 @@
+#include "config/config.h"
+
+#include "DirtySet.h"
+
+#include <algorithm>
+#include <functional>
+
+namespace dag
+{
+    void DirtySet::reset(std::size_t n)
+    {
+        _dirty.assign(n, 0);
+        _heap.clear();
+        _deferred.clear();
+        _all = true;
+    }
+
+    bool DirtySet::mark(std::uint32_t index)
+    {
+        if (_dirty[index] != 0)
+        {
+            return false;
+        }
+
+        _dirty[index] = 1;
+        _heap.emplace_back(index);
+        std::push_heap(_heap.begin(), _heap.end(), std::greater<std::uint32_t>());
+
+        return true;
+    }
+
+    std::uint32_t DirtySet::pop()
+    {
+        std::pop_heap(_heap.begin(), _heap.end(), std::greater<std::uint32_t>());
+        const auto index = _heap.back();
+        _heap.pop_back();
+        _dirty[index] = 0;
+
+        return index;
+    }
+
+    void DirtySet::restoreDeferred()
+    {
+        for (auto index : _deferred)
+        {
+            mark(index);
+        }
+        _deferred.clear();
+    }
+
+    void DirtySet::clear()
+    {
+        for (auto index : _heap)
+        {
+            _dirty[index] = 0;
+        }
+        _heap.clear();
+        _all = false;
+    }
+}
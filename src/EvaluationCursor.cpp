@@ -0,0 +1,92 @@
+#include "config/config.h"
+
+#include "EvaluationCursor.h"
+#include "EvaluationPlan.h"
+#include "InstanceState.h"
+
+namespace dag
+{
+    EvaluationCursor::~EvaluationCursor()
+    {
+        delete _snapshot;
+    }
+
+    void EvaluationCursor::setSnapshot(bool snapshot)
+    {
+        if (snapshot && _snapshot == nullptr)
+        {
+            _snapshot = new InstanceState();
+        }
+        else if (!snapshot)
+        {
+            delete _snapshot;
+            _snapshot = nullptr;
+        }
+        _hasSnapshot = false;
+    }
+
+    bool EvaluationCursor::evaluate(const EvaluationPlan& plan, std::chrono::nanoseconds budget)
+    {
+        const auto start = std::chrono::steady_clock::now();
+
+        if (_plan != &plan || _compile != plan.numCompiles())
+        {
+            _plan = &plan;
+            _compile = plan.numCompiles();
+            _next = 0;
+            _hasSnapshot = false;
+        }
+
+        ++_numSlices;
+        if (_next == 0)
+        {
+            plan.beginFrame();
+        }
+
+        const std::size_t n = plan.numNodes();
+        while (_next < n)
+        {
+            plan.runNode(_next++);
+            if (_next < n && std::chrono::steady_clock::now() - start >= budget)
+            {
+                return false;
+            }
+        }
+
+        plan.commitFeedback();
+        plan.endFrame();
+        _next = 0;
+        ++_numFrames;
+        if (_snapshot != nullptr)
+        {
+            // Lay out the snapshot once per compile, then only copy.
+            if (!_hasSnapshot)
+            {
+                _snapshot->reset(plan, 1);
+                _hasSnapshot = true;
+            }
+            _snapshot->store(0);
+        }
+
+        return true;
+    }
+
+    dagbase::Variant EvaluationCursor::find(std::string_view path) const
+    {
+        dagbase::Variant retval;
+
+        retval = dagbase::findEndpoint(path, "next", std::uint32_t(_next));
+        if (retval.has_value())
+            return retval;
+
+        retval = dagbase::findEndpoint(path, "numFrames", _numFrames);
+        if (retval.has_value())
+            return retval;
+
+        retval = dagbase::findEndpoint(path, "numSlices", _numSlices);
+        if (retval.has_value())
+            return retval;
+
+        return {};
+    }
+}
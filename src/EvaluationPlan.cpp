@@ -0,0 +1,1162 @@
+#include "config/config.h"
+
+#include "EvaluationPlan.h"
+#include "EvaluationProfile.h"
+#include "InstanceState.h"
+#include "Boundary.h"
+#include "Delay.h"
+#include "ThreadPool.h"
+#include "TopologicalOrder.h"
+#include "core/Graph.h"
+#include "core/GraphNode.h"
+#include "core/Node.h"
+#include "core/Port.h"
+#include "core/TypedPort.h"
+
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace dag
+{
+    namespace
+    {
+        template<typename T>
+        void copyTyped(dagbase::Port* source, dagbase::Port* dest)
+        {
+            static_cast<dagbase::TypedPort<T>*>(dest)->setValue(static_cast<dagbase::TypedPort<T>*>(source)->value());
+        }
+
+        void copyGeneric(dagbase::Port* source, dagbase::Port* dest)
+        {
+            dagbase::ValueVisitor getter;
+            source->accept(getter);
+            dagbase::SetValueVisitor setter(getter.value());
+            dest->accept(setter);
+        }
+
+        template<typename T>
+        bool equalTyped(const dagbase::Port* source, const dagbase::Port* dest)
+        {
+            return static_cast<const dagbase::TypedPort<T>*>(source)->value() == static_cast<const dagbase::TypedPort<T>*>(dest)->value();
+        }
+
+        bool equalNever(const dagbase::Port*, const dagbase::Port*)
+        {
+            return false;
+        }
+
+        template<typename T>
+        bool isTyped(const dagbase::Port& port)
+        {
+            return dynamic_cast<const dagbase::TypedPort<T>*>(&port) != nullptr;
+        }
+
+        template<typename T>
+        struct PortTypeOf;
+
+        template<>
+        struct PortTypeOf<double>
+        {
+            static constexpr auto value = dagbase::PortType::TYPE_DOUBLE;
+        };
+
+        template<>
+        struct PortTypeOf<std::int64_t>
+        {
+            static constexpr auto value = dagbase::PortType::TYPE_INT64;
+        };
+
+        template<>
+        struct PortTypeOf<bool>
+        {
+            static constexpr auto value = dagbase::PortType::TYPE_BOOL;
+        };
+
+        //! A copy between TypedPorts of two types that Port::isCompatibleWith() accepts,
+        //! converting with static_cast rather than through dagbase::Value.
+        template<typename From, typename To>
+        struct ConvertingTransfer
+        {
+            static void copy(dagbase::Port* source, dagbase::Port* dest)
+            {
+                static_cast<dagbase::TypedPort<To>*>(dest)->setValue(static_cast<To>(static_cast<dagbase::TypedPort<From>*>(source)->value()));
+            }
+
+            static bool equal(const dagbase::Port* source, const dagbase::Port* dest)
+            {
+                return static_cast<To>(static_cast<const dagbase::TypedPort<From>*>(source)->value()) == static_cast<const dagbase::TypedPort<To>*>(dest)->value();
+            }
+
+            static bool matches(const dagbase::Port& source, const dagbase::Port& dest)
+            {
+                return source.type() == PortTypeOf<From>::value && dest.type() == PortTypeOf<To>::value && isTyped<From>(source) && isTyped<To>(dest);
+            }
+        };
+
+        //! Selects the first of Conversions that matches a pair of Ports.
+        template<typename... Conversions>
+        struct ConversionMatrix
+        {
+            static PortTransfer::CopyFunc selectCopy(const dagbase::Port& source, const dagbase::Port& dest)
+            {
+                PortTransfer::CopyFunc retval = &copyGeneric;
+
+                ((Conversions::matches(source, dest) && (retval = &Conversions::copy)) || ...);
+
+                return retval;
+            }
+
+            static PortTransfer::EqualFunc selectEqual(const dagbase::Port& source, const dagbase::Port& dest)
+            {
+                PortTransfer::EqualFunc retval = &equalNever;
+
+                ((Conversions::matches(source, dest) && (retval = &Conversions::equal)) || ...);
+
+                return retval;
+            }
+        };
+
+        using Conversions = ConversionMatrix<
+                ConvertingTransfer<std::int64_t, double>,
+                ConvertingTransfer<bool, std::int64_t>,
+                ConvertingTransfer<bool, double>>;
+
+        template<typename T>
+        PortTransfer::CopyFunc selectTyped(const dagbase::Port& source, const dagbase::Port& dest)
+        {
+            if (isTyped<T>(source) && isTyped<T>(dest))
+            {
+                return &copyTyped<T>;
+            }
+
+            return &copyGeneric;
+        }
+    }
+
+    PortTransfer::CopyFunc PortTransfer::selectCopy(const dagbase::Port& source, const dagbase::Port& dest)
+    {
+        if (source.type() != dest.type())
+        {
+            return Conversions::selectCopy(source, dest);
+        }
+
+        switch (source.type())
+        {
+            case dagbase::PortType::TYPE_DOUBLE:
+                return selectTyped<double>(source, dest);
+            case dagbase::PortType::TYPE_INT64:
+                return selectTyped<std::int64_t>(source, dest);
+            case dagbase::PortType::TYPE_BOOL:
+                return selectTyped<bool>(source, dest);
+            case dagbase::PortType::TYPE_STRING:
+                return selectTyped<std::string>(source, dest);
+            default:
+                return &copyGeneric;
+        }
+    }
+
+    PortTransfer::EqualFunc PortTransfer::selectEqual(const dagbase::Port& source, const dagbase::Port& dest)
+    {
+        if (source.type() != dest.type())
+        {
+            return Conversions::selectEqual(source, dest);
+        }
+
+        switch (source.type())
+        {
+            case dagbase::PortType::TYPE_DOUBLE:
+                return isTyped<double>(source) && isTyped<double>(dest) ? &equalTyped<double> : &equalNever;
+            case dagbase::PortType::TYPE_INT64:
+                return isTyped<std::int64_t>(source) && isTyped<std::int64_t>(dest) ? &equalTyped<std::int64_t> : &equalNever;
+            case dagbase::PortType::TYPE_BOOL:
+                return isTyped<bool>(source) && isTyped<bool>(dest) ? &equalTyped<bool> : &equalNever;
+            case dagbase::PortType::TYPE_STRING:
+                return isTyped<std::string>(source) && isTyped<std::string>(dest) ? &equalTyped<std::string> : &equalNever;
+            default:
+                return &equalNever;
+        }
+    }
+
+    dagbase::Status EvaluationPlan::compile(dagbase::Graph& graph, const TopologicalOrder* topology)
+    {
+        _nodes.clear();
+        _transfers.clear();
+        _firstTransfer.clear();
+        _sourceNode.clear();
+        _firstNodeOfLevel.clear();
+        _numPredecessors.clear();
+        _firstSuccessor.clear();
+        _successors.clear();
+        _firstPushed.clear();
+        _pushed.clear();
+        _firstPulled.clear();
+        _pulled.clear();
+        _destNode.clear();
+        _firstOutgoing.clear();
+        _outgoing.clear();
+        _portNode.clear();
+        _watched.clear();
+        _cones.clear();
+        _boundaryIndirection.clear();
+        _numFlattened = 0;
+        _pathLength.clear();
+        _feedback.clear();
+        _feedbackSource.clear();
+        _feedbackDest.clear();
+        _batch.reset();
+        _instanceState = nullptr;
+        _valid = false;
+
+        dagbase::NodeArray order;
+        if (topology != nullptr && topology->isValid())
+        {
+            topology->sorted(&order);
+        }
+        else if (graph.topologicalSort(&order) != dagbase::Graph::OK)
+        {
+            return dagbase::Status{dagbase::Status::STATUS_CYCLE_DETECTED};
+        }
+
+        // The Boundaries of a cached child Graph mark where it starts and ends, so they stay.
+        std::unordered_set<const dagbase::Node*> unflattened;
+        _memoisation.find(order, unflattened);
+
+        if (_flattenBoundaries)
+        {
+            for (auto node : order)
+            {
+                auto boundary = dynamic_cast<Boundary*>(node);
+                if (boundary == nullptr || unflattened.count(boundary) != 0)
+                {
+                    continue;
+                }
+
+                for (std::size_t portIndex=0; portIndex<boundary->totalPorts(); ++portIndex)
+                {
+                    auto port = boundary->dynamicPort(portIndex);
+
+                    if (port->dir() == dagbase::PortDirection::DIR_OUT)
+                    {
+                        if (auto partner = boundary->partner(*port))
+                        {
+                            _boundaryIndirection.emplace(port, partner);
+                        }
+                    }
+                    else if (port->dir() == dagbase::PortDirection::DIR_IN && !port->incomingConnections().empty())
+                    {
+                        _boundaryIndirection.emplace(port, port->incomingConnections()[0]);
+                    }
+                }
+            }
+        }
+
+        // Boundary Ports are shared with the GraphNode that owns the child Graph,
+        // so record each incoming transfer against the first Node that exposes it.
+        std::unordered_set<const dagbase::Port*> seen;
+        std::unordered_map<const dagbase::Port*, std::uint32_t> producers;
+        NodeArray sorted;
+        TransferArray transfers;
+        IndexArray firstTransfer;
+        IndexArray sourceNode;
+        IndexArray levels;
+
+        sorted.reserve(order.size());
+        firstTransfer.reserve(order.size() + 1);
+        levels.reserve(order.size());
+        for (auto node : order)
+        {
+            // The children of a GraphNode are already part of the order.
+            if (dynamic_cast<dagbase::GraphNode*>(node) != nullptr)
+            {
+                continue;
+            }
+
+            // Transfers through a flattened Boundary go straight from source to sink.
+            if (_flattenBoundaries && dynamic_cast<Boundary*>(node) != nullptr && unflattened.count(node) == 0)
+            {
+                ++_numFlattened;
+                continue;
+            }
+
+            const auto index = std::uint32_t(sorted.size());
+            std::uint32_t level = 0;
+
+            firstTransfer.emplace_back(std::uint32_t(transfers.size()));
+            sorted.emplace_back(node);
+            for (std::size_t portIndex=0; portIndex<node->totalPorts(); ++portIndex)
+            {
+                auto port = node->dynamicPort(portIndex);
+
+                if (port == nullptr)
+                {
+                    continue;
+                }
+
+                if (port->dir() == dagbase::PortDirection::DIR_OUT)
+                {
+                    producers.emplace(port, index);
+                    continue;
+                }
+
+                if (port->dir() != dagbase::PortDirection::DIR_IN || !seen.insert(port).second)
+                {
+                    continue;
+                }
+
+                for (auto connection : port->incomingConnections())
+                {
+                    auto source = resolve(connection);
+                    PortTransfer transfer;
+
+                    transfer.source = source;
+                    transfer.dest = port;
+                    transfer.copy = PortTransfer::selectCopy(*source, *port);
+                    transfer.equal = PortTransfer::selectEqual(*source, *port);
+                    // A feedback edge neither orders nor levels the Delay, see commitFeedback().
+                    if (Delay::isFeedback(node))
+                    {
+                        _feedback.emplace_back(transfer);
+                        continue;
+                    }
+                    transfers.emplace_back(transfer);
+
+                    // The order is topological so every producer has already been visited.
+                    auto it = producers.find(source);
+                    if (it != producers.end())
+                    {
+                        sourceNode.emplace_back(it->second);
+                        level = std::max(level, levels[it->second] + 1);
+                    }
+                    else
+                    {
+                        sourceNode.emplace_back(NO_NODE);
+                    }
+                }
+            }
+            levels.emplace_back(level);
+        }
+        firstTransfer.emplace_back(std::uint32_t(transfers.size()));
+
+        // Counting sort by level, which keeps the order topological and stable within a level.
+        const std::uint32_t numLevels = levels.empty() ? 0 : *std::max_element(levels.begin(), levels.end()) + 1;
+        _firstNodeOfLevel.assign(numLevels + 1, 0);
+        for (auto level : levels)
+        {
+            ++_firstNodeOfLevel[level + 1];
+        }
+        for (std::uint32_t l=0; l<numLevels; ++l)
+        {
+            _firstNodeOfLevel[l + 1] += _firstNodeOfLevel[l];
+        }
+
+        IndexArray newIndex(sorted.size());
+        {
+            IndexArray next(_firstNodeOfLevel.begin(), _firstNodeOfLevel.end() - 1);
+            for (std::size_t i=0; i<sorted.size(); ++i)
+            {
+                newIndex[i] = next[levels[i]]++;
+            }
+        }
+
+        IndexArray oldIndex(sorted.size());
+        for (std::size_t i=0; i<sorted.size(); ++i)
+        {
+            oldIndex[newIndex[i]] = std::uint32_t(i);
+        }
+
+        _nodes.reserve(sorted.size());
+        _transfers.reserve(transfers.size());
+        _sourceNode.reserve(transfers.size());
+        _firstTransfer.reserve(sorted.size() + 1);
+        _destNode.reserve(transfers.size());
+        for (auto i : oldIndex)
+        {
+            const auto index = std::uint32_t(_nodes.size());
+
+            _firstTransfer.emplace_back(std::uint32_t(_transfers.size()));
+            _nodes.emplace_back(sorted[i]);
+            for (std::uint32_t t=firstTransfer[i]; t<firstTransfer[i+1]; ++t)
+            {
+                _transfers.emplace_back(transfers[t]);
+                _sourceNode.emplace_back(sourceNode[t] != NO_NODE ? newIndex[sourceNode[t]] : NO_NODE);
+                _destNode.emplace_back(index);
+            }
+            for (std::size_t portIndex=0; portIndex<sorted[i]->totalPorts(); ++portIndex)
+            {
+                auto port = sorted[i]->dynamicPort(portIndex);
+
+                if (port != nullptr)
+                {
+                    _portNode.emplace(port, index);
+                }
+            }
+        }
+        _firstTransfer.emplace_back(std::uint32_t(_transfers.size()));
+        for (const auto& transfer : _feedback)
+        {
+            auto it = _portNode.find(transfer.source);
+
+            _feedbackSource.emplace_back(it != _portNode.end() ? it->second : NO_NODE);
+            _feedbackDest.emplace_back(_portNode[transfer.dest]);
+        }
+        _dirty.reset(_nodes.size());
+        buildAdjacency();
+        watchPorts();
+        _folding.compile(*this);
+        _liveness.compile(*this);
+        _gating.compile(*this);
+        _memoisation.index(*this);
+        _schedule.compile(*this);
+        fuseChains();
+        weighCriticalPath(nullptr);
+        ++_numCompiles;
+        _valid = true;
+
+        return dagbase::Status{dagbase::Status::STATUS_OK};
+    }
+
+    void EvaluationPlan::buildAdjacency()
+    {
+        const std::size_t n = _nodes.size();
+        std::unordered_map<const dagbase::Port*, std::uint32_t> fanIn;
+        std::vector<bool> isPushed(_transfers.size(), false);
+
+        for (const auto& transfer : _transfers)
+        {
+            ++fanIn[transfer.dest];
+        }
+
+        _numPredecessors.assign(n, 0);
+        _firstSuccessor.assign(n + 1, 0);
+        _firstPushed.assign(n + 1, 0);
+        _firstPulled.assign(n + 1, 0);
+        _firstOutgoing.assign(n + 1, 0);
+
+        // Count first, then fill, so that each array is a single allocation.
+        IndexArray producers;
+        for (std::size_t i=0; i<n; ++i)
+        {
+            producers.clear();
+            for (std::uint32_t t=_firstTransfer[i]; t<_firstTransfer[i+1]; ++t)
+            {
+                const auto source = _sourceNode[t];
+
+                isPushed[t] = source != NO_NODE && fanIn[_transfers[t].dest] == 1;
+                if (isPushed[t])
+                {
+                    ++_firstPushed[source + 1];
+                }
+                else
+                {
+                    ++_firstPulled[i + 1];
+                }
+                if (source != NO_NODE)
+                {
+                    ++_firstOutgoing[source + 1];
+                    producers.emplace_back(source);
+                }
+            }
+            std::sort(producers.begin(), producers.end());
+            producers.erase(std::unique(producers.begin(), producers.end()), producers.end());
+            _numPredecessors[i] = std::uint32_t(producers.size());
+            for (auto producer : producers)
+            {
+                ++_firstSuccessor[producer + 1];
+            }
+        }
+
+        for (std::size_t i=0; i<n; ++i)
+        {
+            _firstSuccessor[i + 1] += _firstSuccessor[i];
+            _firstPushed[i + 1] += _firstPushed[i];
+            _firstPulled[i + 1] += _firstPulled[i];
+            _firstOutgoing[i + 1] += _firstOutgoing[i];
+        }
+
+        _successors.resize(_firstSuccessor[n]);
+        _pushed.resize(_firstPushed[n]);
+        _pulled.resize(_firstPulled[n]);
+        _outgoing.resize(_firstOutgoing[n]);
+
+        IndexArray nextSuccessor(_firstSuccessor.begin(), _firstSuccessor.end() - 1);
+        IndexArray nextPushed(_firstPushed.begin(), _firstPushed.end() - 1);
+        IndexArray nextOutgoing(_firstOutgoing.begin(), _firstOutgoing.end() - 1);
+        for (std::size_t i=0; i<n; ++i)
+        {
+            std::uint32_t nextPulled = _firstPulled[i];
+
+            producers.clear();
+            for (std::uint32_t t=_firstTransfer[i]; t<_firstTransfer[i+1]; ++t)
+            {
+                const auto source = _sourceNode[t];
+
+                if (isPushed[t])
+                {
+                    _pushed[nextPushed[source]++] = t;
+                }
+                else
+                {
+                    _pulled[nextPulled++] = t;
+                }
+                if (source != NO_NODE)
+                {
+                    _outgoing[nextOutgoing[source]++] = t;
+                    producers.emplace_back(source);
+                }
+            }
+            std::sort(producers.begin(), producers.end());
+            producers.erase(std::unique(producers.begin(), producers.end()), producers.end());
+            for (auto producer : producers)
+            {
+                _successors[nextSuccessor[producer]++] = std::uint32_t(i);
+            }
+        }
+    }
+
+    void EvaluationPlan::setMemoise(dagbase::NodeID graphNode, std::size_t capacity)
+    {
+        _memoisation.setMemoise(graphNode, capacity);
+        _valid = false;
+    }
+
+    void EvaluationPlan::setDivisor(dagbase::NodeID id, std::uint32_t divisor)
+    {
+        _schedule.setDivisor(id, divisor);
+        // A Node with a divisor is never fused, so the chains must be found again.
+        if (_valid && _fusion.isEnabled())
+        {
+            _valid = false;
+        }
+        else if (_valid)
+        {
+            _schedule.compile(*this);
+        }
+    }
+
+    void EvaluationPlan::beginFrame() const
+    {
+        _schedule.beginFrame();
+    }
+
+    void EvaluationPlan::pin(dagbase::PortID id)
+    {
+        if (_liveness.pin(id) && _valid)
+        {
+            _liveness.compile(*this);
+        }
+    }
+
+    void EvaluationPlan::unpin(dagbase::PortID id)
+    {
+        if (_liveness.unpin(id) && _valid)
+        {
+            _liveness.compile(*this);
+        }
+    }
+
+    void EvaluationPlan::fuseChains()
+    {
+        const std::size_t n = _nodes.size();
+        std::vector<std::uint8_t> fusable(n, 0);
+
+        // A chain runs as one step, so every link must run whenever its head does.
+        for (std::size_t i=0; i<n; ++i)
+        {
+            fusable[i] = !_folding.isFolded(i) && _liveness.isLive(i) && !_gating.isGated(i) && !_schedule.hasDivisor(i) ? 1 : 0;
+        }
+        _fusion.compile(*this, fusable, _memoisation.regions());
+    }
+
+    void EvaluationPlan::runNode(std::size_t index) const
+    {
+        if (isSkipped(index) || _gating.gate(*this, index))
+        {
+            return;
+        }
+
+        const PortTransfer* transfers = _transfers.data();
+        const auto chain = _fusion.chainOf(index);
+
+        for (std::uint32_t p=_firstPulled[index]; p<_firstPulled[index+1]; ++p)
+        {
+            transfers[_pulled[p]].makeItSo();
+        }
+        if (chain == ChainFusion::NO_CHAIN)
+        {
+            _nodes[index]->update();
+            for (std::uint32_t p=_firstPushed[index]; p<_firstPushed[index+1]; ++p)
+            {
+                transfers[_pushed[p]].makeItSo();
+            }
+        }
+        else
+        {
+            // Every link has an output, and consumers off the chain wait for it to be pushed.
+            _fusion.run(chain);
+            for (auto link : _fusion.links(chain))
+            {
+                for (std::uint32_t p=_firstPushed[link]; p<_firstPushed[link+1]; ++p)
+                {
+                    transfers[_pushed[p]].makeItSo();
+                }
+            }
+        }
+        nodeUpdated(index);
+    }
+
+    template<typename Instrumentation>
+    void EvaluationPlan::evaluateNode(std::size_t index, Instrumentation& instrumentation) const
+    {
+        if (isSkipped(index) || _gating.gate(*this, index))
+        {
+            return;
+        }
+
+        const auto chain = _fusion.chainOf(index);
+        if (chain == ChainFusion::NO_CHAIN)
+        {
+            updateNode(index, instrumentation);
+        }
+        else
+        {
+            evaluateChain(chain, instrumentation);
+        }
+    }
+
+    void EvaluationPlan::evaluateNode(std::size_t index) const
+    {
+        NoInstrumentation instrumentation;
+
+        evaluateNode(index, instrumentation);
+    }
+
+    void EvaluationPlan::weighCriticalPath(const EvaluationProfile* profile)
+    {
+        const std::size_t n = _nodes.size();
+
+        _pathLength.assign(n, 0);
+        // Successors have higher indices, so walking backwards sees them first.
+        for (std::size_t i=n; i-- > 0;)
+        {
+            std::uint64_t cost = 0;
+
+            if (profile != nullptr)
+            {
+                cost = profile->meanNodeNanos(_nodes[i]->id());
+                for (std::uint32_t t=_firstTransfer[i]; t<_firstTransfer[i+1]; ++t)
+                {
+                    cost += profile->meanTransferNanos(_transfers[t].dest->id());
+                }
+            }
+
+            std::uint64_t longest = 0;
+            for (auto successor = beginSuccessors(i); successor != endSuccessors(i); ++successor)
+            {
+                longest = std::max(longest, _pathLength[*successor]);
+            }
+            _pathLength[i] = std::max(cost, std::uint64_t{1}) + longest;
+        }
+    }
+
+    template<typename Instrumentation>
+    void EvaluationPlan::updateNode(std::size_t index, Instrumentation& instrumentation) const
+    {
+        const PortTransfer* transfers = _transfers.data();
+
+        for (std::uint32_t t=_firstTransfer[index]; t<_firstTransfer[index+1]; ++t)
+        {
+            instrumentation.beginTransfer(t);
+            transfers[t].makeItSo();
+            instrumentation.endTransfer(t);
+        }
+        instrumentation.beginNode(index);
+        _nodes[index]->update();
+        instrumentation.endNode(index);
+        nodeUpdated(index);
+    }
+
+    void EvaluationPlan::updateNode(std::size_t index) const
+    {
+        NoInstrumentation instrumentation;
+
+        updateNode(index, instrumentation);
+    }
+
+    template<typename Instrumentation>
+    void EvaluationPlan::evaluateStep(std::size_t index, Instrumentation& instrumentation)
+    {
+        if (_memoisation.isEmpty())
+        {
+            evaluateNode(index, instrumentation);
+
+            return;
+        }
+
+        if (!_memoisation.skips(index))
+        {
+            evaluateNode(index, instrumentation);
+            _memoisation.afterNode(index);
+        }
+    }
+
+    template<typename Instrumentation>
+    void EvaluationPlan::evaluateFrame(Instrumentation& instrumentation)
+    {
+        beginFrame();
+        _memoisation.beginFrame();
+        if (_schedule.hasRates())
+        {
+            // Only the Nodes due this frame are visited.
+            for (auto i : _schedule.dueNodes())
+            {
+                evaluateStep(i, instrumentation);
+            }
+        }
+        else
+        {
+            const std::size_t n = _nodes.size();
+
+            for (std::size_t i=0; i<n; ++i)
+            {
+                evaluateStep(i, instrumentation);
+            }
+        }
+        commitFeedback();
+        endFrame();
+    }
+
+    void EvaluationPlan::evaluate()
+    {
+        NoInstrumentation instrumentation;
+
+        evaluateFrame(instrumentation);
+    }
+
+    template<typename Instrumentation>
+    void EvaluationPlan::evaluateChain(std::uint32_t chain, Instrumentation& instrumentation) const
+    {
+        const auto head = _fusion.head(chain);
+
+        for (std::uint32_t t=_firstTransfer[head]; t<_firstTransfer[head+1]; ++t)
+        {
+            instrumentation.beginTransfer(t);
+            _transfers[t].makeItSo();
+            instrumentation.endTransfer(t);
+        }
+
+        // The whole kernel is timed as the update() of the head.
+        instrumentation.beginNode(head);
+        _fusion.run(chain);
+        instrumentation.endNode(head);
+        nodeUpdated(head);
+    }
+
+    void EvaluationPlan::commitFeedback() const
+    {
+        for (const auto& transfer : _feedback)
+        {
+            transfer.makeItSo();
+        }
+    }
+
+    void EvaluationPlan::evaluate(EvaluationProfile& profile)
+    {
+        TimingInstrumentation instrumentation(profile);
+
+        if (!profile.matches(*this))
+        {
+            profile.reset(*this);
+        }
+
+        evaluateFrame(instrumentation);
+    }
+
+    void EvaluationPlan::evaluateParallel(ThreadPool& pool)
+    {
+        // Below this many Nodes the cost of waking the workers outweighs the work.
+        constexpr std::size_t minParallelNodes = 32;
+
+        beginFrame();
+        const auto& due = _schedule.dueNodes();
+        for (std::size_t level=0; level<numLevels(); ++level)
+        {
+            const auto begin = _firstNodeOfLevel[level];
+            const auto end = _firstNodeOfLevel[level + 1];
+            // The due Nodes of a level are a contiguous run of the sorted due list.
+            const std::uint32_t* first = nullptr;
+            std::size_t count = end - begin;
+
+            if (_schedule.hasRates())
+            {
+                auto lower = std::lower_bound(due.begin(), due.end(), begin);
+                auto upper = std::lower_bound(lower, due.end(), end);
+                first = due.data() + (lower - due.begin());
+                count = upper - lower;
+            }
+
+            auto nodeAt = [first, begin](std::size_t k) -> std::size_t
+            {
+                return first != nullptr ? first[k] : begin + k;
+            };
+            if (count < minParallelNodes || pool.numThreads() == 1)
+            {
+                for (std::size_t k=0; k<count; ++k)
+                {
+                    evaluateNode(nodeAt(k));
+                }
+            }
+            else
+            {
+                auto f = [this, &nodeAt](std::size_t k)
+                {
+                    evaluateNode(nodeAt(k));
+                };
+                pool.parallelFor(count, f);
+            }
+        }
+        commitFeedback();
+        endFrame();
+    }
+
+    void EvaluationPlan::markDirty(const dagbase::Port& port)
+    {
+        if (!_valid)
+        {
+            return;
+        }
+
+        const auto index = nodeOf(&port);
+        if (index != NO_NODE)
+        {
+            markNodeDirty(index);
+
+            return;
+        }
+
+        // A Port outside the plan, such as the input of a flattened GraphNode, feeds its consumers directly.
+        for (std::size_t t=0; t<_transfers.size(); ++t)
+        {
+            if (_transfers[t].source == &port)
+            {
+                markNodeDirty(_destNode[t]);
+            }
+        }
+    }
+
+    void EvaluationPlan::watchPorts()
+    {
+        std::unordered_set<const dagbase::Port*> seen;
+        auto watch = [this, &seen](const dagbase::Port* port)
+        {
+            auto counter = dynamic_cast<const ChangeCounter*>(port);
+
+            if (counter != nullptr && seen.insert(port).second)
+            {
+                _watched.emplace_back(WatchedPort{port, counter, counter->generation()});
+            }
+        };
+
+        for (const auto& entry : _portNode)
+        {
+            watch(entry.first);
+        }
+        // A source outside the plan, such as the input of a flattened GraphNode.
+        for (const auto& transfer : _transfers)
+        {
+            watch(transfer.source);
+        }
+    }
+
+    void EvaluationPlan::collectChanges()
+    {
+        for (auto& watched : _watched)
+        {
+            const auto generation = watched.counter->generation();
+
+            if (generation != watched.generation)
+            {
+                watched.generation = generation;
+                markDirty(*watched.port);
+            }
+        }
+    }
+
+    void EvaluationPlan::markNodeDirty(std::uint32_t index)
+    {
+        if (_folding.isFolded(index))
+        {
+            _folding.unfold(*this, index);
+        }
+
+        _dirty.mark(index);
+    }
+
+    void EvaluationPlan::clearDirty()
+    {
+        _dirty.clear();
+    }
+
+    void EvaluationPlan::evaluateDirty()
+    {
+        collectChanges();
+        if (_dirty.isAll())
+        {
+            evaluate();
+            clearDirty();
+            _numUpdated = _liveness.numLive();
+
+            return;
+        }
+
+        _numUpdated = 0;
+        beginFrame();
+        // Successors always have a higher index than their producers,
+        // so taking the smallest index first keeps the order topological.
+        while (!_dirty.empty())
+        {
+            const auto index = _dirty.pop();
+            if (!isLive(index))
+            {
+                continue;
+            }
+
+            // A Node that is not due stays dirty until a frame in which it is.
+            if (!_schedule.isDue(index))
+            {
+                _dirty.defer(index);
+                continue;
+            }
+
+            const std::uint8_t wasClosed = _gating.closed(index);
+            const auto chain = _fusion.chainOf(index);
+            if (_fusion.isFused(index))
+            {
+                // A link made dirty on its own runs alone, as it would without fusion.
+                updateNode(index);
+            }
+            else
+            {
+                evaluateNode(index);
+            }
+            ++_numUpdated;
+            // Opening or closing a gate changes whether the successors run, even if no value changed.
+            const bool gateChanged = _gating.closed(index) != wasClosed;
+            // The kernel of a chain writes the outputs of every link.
+            const std::size_t numRun = chain != ChainFusion::NO_CHAIN ? _fusion.links(chain).size() : 1;
+            for (std::size_t k=0; k<numRun; ++k)
+            {
+                const auto node = chain != ChainFusion::NO_CHAIN ? _fusion.links(chain)[k] : index;
+
+                for (auto o = beginOutgoing(node); o != endOutgoing(node); ++o)
+                {
+                    if (gateChanged || !_transfers[*o].isCurrent())
+                    {
+                        markNodeDirty(_destNode[*o]);
+                    }
+                }
+            }
+        }
+
+        // A changed feedback value is seen by its Delay on the next call.
+        for (std::size_t f=0; f<_feedback.size(); ++f)
+        {
+            if (!_feedback[f].isCurrent())
+            {
+                _feedback[f].makeItSo();
+                markNodeDirty(_feedbackDest[f]);
+            }
+        }
+        _dirty.restoreDeferred();
+        endFrame();
+    }
+
+    dagbase::Port* EvaluationPlan::resolve(dagbase::Port* port) const
+    {
+        for (auto it = _boundaryIndirection.find(port); it != _boundaryIndirection.end(); it = _boundaryIndirection.find(port))
+        {
+            port = it->second;
+        }
+
+        return port;
+    }
+
+    bool EvaluationPlan::evaluateFor(dagbase::Port& port)
+    {
+        auto source = resolve(&port);
+        const auto index = nodeOf(source);
+        if (index == NO_NODE && source == &port)
+        {
+            return false;
+        }
+
+        _numUpdated = 0;
+        if (index != NO_NODE)
+        {
+            // The Port is observed, so dead Nodes in the cone are evaluated too.
+            const auto& cone = _cones.coneFor(*this, index);
+            for (auto i : cone)
+            {
+                if (!_folding.isCurrent(i) || !isLive(i))
+                {
+                    updateNode(i);
+                }
+            }
+            _numUpdated = std::uint32_t(cone.size());
+        }
+
+        // A flattened Boundary Port is only brought up to date on demand.
+        if (source != &port)
+        {
+            copyGeneric(source, &port);
+        }
+
+        return true;
+    }
+
+    void EvaluationPlan::prepareBatch(BatchContext& context, std::size_t n)
+    {
+        _batch.prepare(*this, context, n);
+    }
+
+    void EvaluationPlan::evaluateBatch()
+    {
+        _batch.evaluate(*this);
+    }
+
+    bool EvaluationPlan::prepareInstances(InstanceState& state, std::size_t n)
+    {
+        _instanceState = state.reset(*this, n) ? &state : nullptr;
+
+        return _instanceState != nullptr;
+    }
+
+    void EvaluationPlan::evaluateInstances()
+    {
+        const std::size_t n = _nodes.size();
+
+        // The instances share one frame, so they share one tick.
+        beginFrame();
+        for (std::size_t instance=0; instance<_instanceState->numInstances(); ++instance)
+        {
+            for (std::size_t i=0; i<n; ++i)
+            {
+                // Conditions close their consumers per instance, because the gates are loaded from the block.
+                if (!isLive(i) || !_schedule.isDue(i) || _gating.gate(*this, i))
+                {
+                    continue;
+                }
+
+                _instanceState->load(instance, i);
+                _nodes[i]->update();
+                _instanceState->store(instance, i);
+                _gating.updateGate(i);
+            }
+            _instanceState->commitFeedback(instance);
+        }
+        endFrame();
+    }
+
+    dagbase::Variant EvaluationPlan::find(std::string_view path) const
+    {
+        dagbase::Variant retval;
+        retval = dagbase::findEndpoint(path, "numNodes", std::uint32_t(_nodes.size()));
+        if (retval.has_value())
+            return retval;
+
+        retval = dagbase::findEndpoint(path, "numTransfers", std::uint32_t(_transfers.size()));
+        if (retval.has_value())
+            return retval;
+
+        retval = dagbase::findEndpoint(path, "numLevels", std::uint32_t(numLevels()));
+        if (retval.has_value())
+            return retval;
+
+        retval = dagbase::findEndpoint(path, "numUpdated", _numUpdated);
+        if (retval.has_value())
+            return retval;
+
+        retval = dagbase::findEndpoint(path, "numLive", _liveness.numLive());
+        if (retval.has_value())
+            return retval;
+
+        retval = dagbase::findEndpoint(path, "numPruned", std::uint32_t(_nodes.size() - _liveness.numLive()));
+        if (retval.has_value())
+            return retval;
+
+        retval = dagbase::findEndpoint(path, "numMemos", std::uint32_t(_memoisation.numMemos()));
+        if (retval.has_value())
+            return retval;
+
+        retval = dagbase::findEndpoint(path, "numMemoHits", _memoisation.numHits());
+        if (retval.has_value())
+            return retval;
+
+        retval = dagbase::findEndpoint(path, "numMemoMisses", _memoisation.numMisses());
+        if (retval.has_value())
+            return retval;
+
+        retval = _memoisation.find(path);
+        if (retval.has_value())
+            return retval;
+
+        retval = dagbase::findEndpoint(path, "criticalPathLength", std::int64_t(_pathLength.empty() ? 0 : *std::max_element(_pathLength.begin(), _pathLength.end())));
+        if (retval.has_value())
+            return retval;
+
+        retval = dagbase::findEndpoint(path, "numChains", std::uint32_t(_fusion.numChains()));
+        if (retval.has_value())
+            return retval;
+
+        retval = dagbase::findEndpoint(path, "numFused", _fusion.numFused());
+        if (retval.has_value())
+            return retval;
+
+        retval = dagbase::findEndpoint(path, "numAliased", _batch.numAliased());
+        if (retval.has_value())
+            return retval;
+
+        retval = dagbase::findEndpoint(path, "numFeedback", std::uint32_t(_feedback.size()));
+        if (retval.has_value())
+            return retval;
+
+        retval = dagbase::findEndpoint(path, "tick", std::int64_t(_schedule.tick()));
+        if (retval.has_value())
+            return retval;
+
+        retval = dagbase::findEndpoint(path, "numRates", std::uint32_t(_schedule.numRates()));
+        if (retval.has_value())
+            return retval;
+
+        retval = dagbase::findEndpoint(path, "numDue", _schedule.numDue());
+        if (retval.has_value())
+            return retval;
+
+        retval = dagbase::findEndpoint(path, "numConditions", _gating.numConditions());
+        if (retval.has_value())
+            return retval;
+
+        retval = dagbase::findEndpoint(path, "numGated", _gating.numGated());
+        if (retval.has_value())
+            return retval;
+
+        retval = dagbase::findEndpoint(path, "numFolded", _folding.numFolded());
+        if (retval.has_value())
+            return retval;
+
+        retval = dagbase::findEndpoint(path, "numFlattened", _numFlattened);
+        if (retval.has_value())
+            return retval;
+
+        retval = dagbase::findEndpoint(path, "numCones", std::uint32_t(_cones.size()));
+        if (retval.has_value())
+            return retval;
+
+        retval = dagbase::findEndpoint(path, "numCompiles", _numCompiles);
+        if (retval.has_value())
+            return retval;
+
+        return {};
+    }
+}
@@ -0,0 +1,209 @@
+#include "config/config.h"
+
+#include "EvaluationProfile.h"
+#include "EvaluationPlan.h"
+#include "core/Node.h"
+#include "core/Port.h"
+
+#include <algorithm>
+#include <charconv>
+#include <ostream>
+
+namespace dag
+{
+    namespace
+    {
+        //! Split name[index].rest into index and rest.
+        bool splitIndex(std::string_view path, std::string_view name, std::uint32_t& index, std::string_view& rest)
+        {
+            if (path.size() <= name.size() + 1 || path.substr(0, name.size()) != name || path[name.size()] != '[')
+            {
+                return false;
+            }
+
+            const char* begin = path.data() + name.size() + 1;
+            const char* end = path.data() + path.size();
+            auto [ptr, ec] = std::from_chars(begin, end, index);
+            if (ec != std::errc() || end - ptr < 2 || ptr[0] != ']' || ptr[1] != '.')
+            {
+                return false;
+            }
+
+            rest = std::string_view(ptr + 2, std::size_t(end - ptr - 2));
+
+            return true;
+        }
+    }
+
+    dagbase::Variant EvaluationStats::find(std::string_view path) const
+    {
+        dagbase::Variant retval;
+
+        retval = dagbase::findEndpoint(path, "count", std::int64_t(count));
+        if (retval.has_value())
+            return retval;
+
+        retval = dagbase::findEndpoint(path, "totalNanos", std::int64_t(totalNanos));
+        if (retval.has_value())
+            return retval;
+
+        retval = dagbase::findEndpoint(path, "minNanos", std::int64_t(count != 0 ? minNanos : 0));
+        if (retval.has_value())
+            return retval;
+
+        retval = dagbase::findEndpoint(path, "maxNanos", std::int64_t(maxNanos));
+        if (retval.has_value())
+            return retval;
+
+        retval = dagbase::findEndpoint(path, "lastNanos", std::int64_t(lastNanos));
+        if (retval.has_value())
+            return retval;
+
+        return {};
+    }
+
+    void EvaluationProfile::reset(const EvaluationPlan& plan)
+    {
+        const std::size_t numNodes = plan.numNodes();
+        const std::size_t numTransfers = plan.numTransfers();
+
+        _nodeStats.assign(numNodes, EvaluationStats());
+        _transferStats.assign(numTransfers, EvaluationStats());
+        _nodeIds.resize(numNodes);
+        _nodeNames.resize(numNodes);
+        _nodeIndex.clear();
+        for (std::size_t i=0; i<numNodes; ++i)
+        {
+            auto node = plan.node(i);
+
+            _nodeIds[i] = node->id();
+            _nodeIndex[std::uint32_t(node->id())] = i;
+            _nodeNames[i] = node->name() + " (node " + std::to_string(std::uint32_t(node->id())) + ")";
+        }
+        _transferIds.resize(numTransfers);
+        _transferNames.resize(numTransfers);
+        _transferIndex.clear();
+        for (std::size_t t=0; t<numTransfers; ++t)
+        {
+            const auto& transfer = plan.transfer(t);
+
+            _transferIds[t] = transfer.dest->id();
+            _transferIndex[std::uint32_t(transfer.dest->id())] = t;
+            _transferNames[t] = "transfer from port " + std::to_string(std::uint32_t(transfer.source->id())) +
+                                " to port " + std::to_string(std::uint32_t(transfer.dest->id()));
+        }
+        _plan = &plan;
+        _compile = plan.numCompiles();
+    }
+
+    bool EvaluationProfile::matches(const EvaluationPlan& plan) const
+    {
+        return _plan == &plan && _compile == plan.numCompiles();
+    }
+
+    std::uint64_t EvaluationProfile::meanNodeNanos(dagbase::NodeID id) const
+    {
+        auto it = _nodeIndex.find(std::uint32_t(id));
+        if (it == _nodeIndex.end())
+        {
+            return 0;
+        }
+
+        const auto& stats = _nodeStats[it->second];
+
+        return stats.count != 0 ? stats.totalNanos / stats.count : 0;
+    }
+
+    std::uint64_t EvaluationProfile::meanTransferNanos(dagbase::PortID id) const
+    {
+        auto it = _transferIndex.find(std::uint32_t(id));
+        if (it == _transferIndex.end())
+        {
+            return 0;
+        }
+
+        const auto& stats = _transferStats[it->second];
+
+        return stats.count != 0 ? stats.totalNanos / stats.count : 0;
+    }
+
+    EvaluationProfile::HotSpotArray EvaluationProfile::hotList(std::size_t count) const
+    {
+        HotSpotArray hotSpots;
+
+        hotSpots.reserve(_nodeStats.size() + _transferStats.size());
+        for (std::size_t i=0; i<_nodeStats.size(); ++i)
+        {
+            hotSpots.emplace_back(HotSpot{_nodeNames[i], _nodeStats[i]});
+        }
+        for (std::size_t t=0; t<_transferStats.size(); ++t)
+        {
+            hotSpots.emplace_back(HotSpot{_transferNames[t], _transferStats[t]});
+        }
+
+        count = std::min(count, hotSpots.size());
+        std::partial_sort(hotSpots.begin(), hotSpots.begin() + std::ptrdiff_t(count), hotSpots.end(),
+                          [](const HotSpot& a, const HotSpot& b)
+                          {
+                              return a.stats.totalNanos > b.stats.totalNanos;
+                          });
+        hotSpots.resize(count);
+
+        return hotSpots;
+    }
+
+    void EvaluationProfile::writeHotList(std::ostream& str, std::size_t count) const
+    {
+        for (const auto& hotSpot : hotList(count))
+        {
+            const auto& stats = hotSpot.stats;
+
+            str << hotSpot.name << ": count=" << stats.count << " total=" << stats.totalNanos
+                << "ns min=" << (stats.count != 0 ? stats.minNanos : 0) << "ns max=" << stats.maxNanos
+                << "ns last=" << stats.lastNanos << "ns\n";
+        }
+    }
+
+    dagbase::Variant EvaluationProfile::find(std::string_view path) const
+    {
+        dagbase::Variant retval;
+        std::uint32_t id = 0;
+        std::string_view rest;
+
+        if (splitIndex(path, "nodes", id, rest))
+        {
+            for (std::size_t i=0; i<_nodeIds.size(); ++i)
+            {
+                if (_nodeIds[i] == dagbase::NodeID(id))
+                {
+                    return _nodeStats[i].find(rest);
+                }
+            }
+
+            return {};
+        }
+
+        if (splitIndex(path, "transfers", id, rest))
+        {
+            for (std::size_t t=0; t<_transferIds.size(); ++t)
+            {
+                if (_transferIds[t] == dagbase::PortID(id))
+                {
+                    return _transferStats[t].find(rest);
+                }
+            }
+
+            return {};
+        }
+
+        retval = dagbase::findEndpoint(path, "numNodes", std::uint32_t(_nodeStats.size()));
+        if (retval.has_value())
+            return retval;
+
+        retval = dagbase::findEndpoint(path, "numTransfers", std::uint32_t(_transferStats.size()));
+        if (retval.has_value())
+            return retval;
+
+        return {};
+    }
+}
@@ -0,0 +1,59 @@
+#include "config/config.h"
+
+#include "FastMath.h"
+
+namespace dag
+{
+    namespace
+    {
+        template<FastMath::Accuracy accuracy>
+        void kernelArray(const double* x, double* y, std::size_t n, double scale, std::uint64_t quadrant)
+        {
+            // No calls and no branches in the body, so the compiler can keep it in vector registers.
+            for (std::size_t i=0; i<n; ++i)
+            {
+                y[i] = FastMath::kernel<accuracy>(x[i] * scale, quadrant);
+            }
+
+            // Arguments too large for the reduction are rare, so fix them up afterwards.
+            for (std::size_t i=0; i<n; ++i)
+            {
+                const double angle = x[i] * scale;
+
+                if (!(std::abs(angle) <= FastMath::reductionLimit))
+                {
+                    y[i] = quadrant == 0 ? std::sin(angle) : std::cos(angle);
+                }
+            }
+        }
+
+        void dispatch(const double* x, double* y, std::size_t n, double scale, FastMath::Accuracy accuracy, std::uint64_t quadrant)
+        {
+            switch (accuracy)
+            {
+            case FastMath::ACCURACY_ULP:
+                kernelArray<FastMath::ACCURACY_ULP>(x, y, n, scale, quadrant);
+                break;
+            case FastMath::ACCURACY_FAST:
+                kernelArray<FastMath::ACCURACY_FAST>(x, y, n, scale, quadrant);
+                break;
+            default:
+                for (std::size_t i=0; i<n; ++i)
+                {
+                    y[i] = quadrant == 0 ? std::sin(x[i] * scale) : std::cos(x[i] * scale);
+                }
+                break;
+            }
+        }
+    }
+
+    void FastMath::sin(const double* x, double* y, std::size_t n, double scale, Accuracy accuracy)
+    {
+        dispatch(x, y, n, scale, accuracy, 0);
+    }
+
+    void FastMath::cos(const double* x, double* y, std::size_t n, double scale, Accuracy accuracy)
+    {
+        dispatch(x, y, n, scale, accuracy, 1);
+    }
+}
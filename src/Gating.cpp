@@ -0,0 +1,130 @@
+#include "config/config.h"
+
+#include "Gating.h"
+#include "EvaluationPlan.h"
+#include "core/Node.h"
+#include "core/Port.h"
+#include "core/TypedPort.h"
+
+namespace dag
+{
+    void Gating::compile(const EvaluationPlan& plan)
+    {
+        const std::size_t n = plan.numNodes();
+
+        _gate.clear();
+        _gated.clear();
+        _closed.clear();
+        _gateMask.clear();
+        _numConditions = 0;
+        _numGated = 0;
+        for (std::size_t i=0; i<n; ++i)
+        {
+            auto node = plan.node(i);
+            if (node->category() != dagbase::NodeCategory::CAT_CONDITION)
+            {
+                continue;
+            }
+
+            // The gate is the first bool output, or failing that the first bool input such as the trigger of Derived.
+            const dagbase::TypedPort<bool>* gate = nullptr;
+            for (std::size_t portIndex=0; portIndex<node->totalPorts(); ++portIndex)
+            {
+                auto port = dynamic_cast<const dagbase::TypedPort<bool>*>(node->dynamicPort(portIndex));
+
+                if (port != nullptr && port->dir() == dagbase::PortDirection::DIR_OUT)
+                {
+                    gate = port;
+                    break;
+                }
+                if (port != nullptr && port->dir() == dagbase::PortDirection::DIR_IN && gate == nullptr)
+                {
+                    gate = port;
+                }
+            }
+            if (gate == nullptr)
+            {
+                continue;
+            }
+
+            if (_gate.empty())
+            {
+                _gate.assign(n, nullptr);
+            }
+            _gate[i] = gate;
+            ++_numConditions;
+        }
+
+        if (_gate.empty())
+        {
+            return;
+        }
+
+        // The order is topological, so the producers of each Node are already known.
+        _gated.assign(n, 0);
+        _closed.assign(n, 0);
+        _gateMask.assign(plan.numTransfers(), 0);
+        for (std::size_t i=0; i<n; ++i)
+        {
+            for (std::uint32_t t=plan.beginTransfer(i); t<plan.endTransfer(i); ++t)
+            {
+                const auto source = plan.sourceNode(t);
+
+                if (source == EvaluationPlan::NO_NODE)
+                {
+                    continue;
+                }
+
+                // A gate that is an input switches off the whole condition, otherwise only the gate itself is gated.
+                const auto gate = _gate[source];
+                if (gate != nullptr && (gate->dir() == dagbase::PortDirection::DIR_IN || plan.transfer(t).source == gate))
+                {
+                    _gateMask[t] = CLOSED_SKIPPED | CLOSED_GATE;
+                }
+                else if (_gated[source])
+                {
+                    _gateMask[t] = CLOSED_SKIPPED;
+                }
+                _gated[i] |= _gateMask[t] != 0 ? 1 : 0;
+            }
+            _numGated += _gated[i];
+        }
+    }
+
+    bool Gating::gate(const EvaluationPlan& plan, std::size_t index) const
+    {
+        if (!isGated(index))
+        {
+            return false;
+        }
+
+        // A skipped condition has a stale gate, so its gate closes its consumers too.
+        _closed[index] = isGatedOff(plan, index) ? CLOSED_SKIPPED : 0;
+
+        return _closed[index] != 0;
+    }
+
+    void Gating::updateGate(std::size_t index) const
+    {
+        if (!_gate.empty() && _gate[index] != nullptr)
+        {
+            _closed[index] = _gate[index]->value() ? 0 : CLOSED_GATE;
+        }
+    }
+
+    bool Gating::isGatedOff(const EvaluationPlan& plan, std::size_t index) const
+    {
+        // An ungated transfer has no bits, so it keeps the Node open.
+        for (std::uint32_t t=plan.beginTransfer(index); t<plan.endTransfer(index); ++t)
+        {
+            const auto source = plan.sourceNode(t);
+
+            if (source == EvaluationPlan::NO_NODE || (_closed[source] & _gateMask[t]) == 0)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+}
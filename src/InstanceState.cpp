@@ -0,0 +1,317 @@
+#include "config/config.h"
+
+#include "InstanceState.h"
+#include "EvaluationPlan.h"
+#include "core/Node.h"
+#include "core/Port.h"
+#include "core/TypedPort.h"
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+namespace dag
+{
+    InstanceState::~InstanceState()
+    {
+        ::operator delete(_block, std::align_val_t(alignment));
+    }
+
+    std::uint32_t InstanceState::addSlot(dagbase::Port* port)
+    {
+        auto it = _slotIndex.find(port);
+        if (it != _slotIndex.end())
+        {
+            return it->second;
+        }
+
+        Slot slot;
+        slot.port = port;
+        slot.type = port->type();
+        slot.isOutput = port->dir() != dagbase::PortDirection::DIR_IN;
+        slot.doublePort = dynamic_cast<dagbase::TypedPort<double>*>(port);
+        slot.int64Port = dynamic_cast<dagbase::TypedPort<std::int64_t>*>(port);
+        slot.boolPort = dynamic_cast<dagbase::TypedPort<bool>*>(port);
+        // Numbers are given their offset once every slot is known, see reset().
+        if (slot.type == dagbase::PortType::TYPE_STRING)
+        {
+            slot.offset = std::uint32_t(_numStrings++);
+        }
+
+        const auto index = std::uint32_t(_slots.size());
+        _slots.emplace_back(slot);
+        _slotIndex.emplace(port, index);
+
+        return index;
+    }
+
+    bool InstanceState::reset(const EvaluationPlan& plan, std::size_t numInstances)
+    {
+        static_assert(sizeof(double) == sizeof(std::int64_t));
+
+        _slots.clear();
+        _slotIndex.clear();
+        _firstSlot.clear();
+        _nodeSlots.clear();
+        _transfers.clear();
+        _firstTransfer.clear();
+        _feedback.clear();
+        _strings.clear();
+        _numStrings = 0;
+        _numInstances = 0;
+        for (std::size_t i=0; i<plan.numNodes(); ++i)
+        {
+            auto node = plan.node(i);
+
+            _firstSlot.emplace_back(std::uint32_t(_nodeSlots.size()));
+            for (std::size_t portIndex=0; portIndex<node->totalPorts(); ++portIndex)
+            {
+                auto port = node->dynamicPort(portIndex);
+
+                if (port == nullptr)
+                {
+                    continue;
+                }
+
+                switch (port->type())
+                {
+                case dagbase::PortType::TYPE_DOUBLE:
+                case dagbase::PortType::TYPE_INT64:
+                case dagbase::PortType::TYPE_BOOL:
+                case dagbase::PortType::TYPE_STRING:
+                    _nodeSlots.emplace_back(addSlot(port));
+                    break;
+                default:
+                    // A value that is not held per instance would be shared by every instance.
+                    _slots.clear();
+                    _slotIndex.clear();
+
+                    return false;
+                }
+            }
+        }
+        _firstSlot.emplace_back(std::uint32_t(_nodeSlots.size()));
+
+        // Numbers are laid out in slot order with the strings kept apart.
+        std::uint32_t numCells = 0;
+        for (auto& slot : _slots)
+        {
+            if (slot.type != dagbase::PortType::TYPE_STRING)
+            {
+                slot.offset = numCells++;
+            }
+        }
+
+        auto slotTransfer = [this](const PortTransfer& transfer)
+        {
+            SlotTransfer slotTransfer;
+            auto source = _slotIndex.find(transfer.source);
+
+            slotTransfer.source = source != _slotIndex.end() ? source->second : NO_SLOT;
+            slotTransfer.dest = _slotIndex.at(transfer.dest);
+            slotTransfer.sourcePort = transfer.source;
+
+            return slotTransfer;
+        };
+        for (std::size_t i=0; i<plan.numNodes(); ++i)
+        {
+            _firstTransfer.emplace_back(std::uint32_t(_transfers.size()));
+            for (std::uint32_t t=plan.beginTransfer(i); t<plan.endTransfer(i); ++t)
+            {
+                _transfers.emplace_back(slotTransfer(plan.transfer(t)));
+            }
+        }
+        _firstTransfer.emplace_back(std::uint32_t(_transfers.size()));
+        for (std::size_t f=0; f<plan.numFeedback(); ++f)
+        {
+            _feedback.emplace_back(slotTransfer(plan.feedbackTransfer(f)));
+        }
+
+        // Round each block up to whole cache lines so that instances never share a line.
+        _numInstances = numInstances;
+        _stride = (std::max(numCells, std::uint32_t{1}) * sizeof(double) + alignment - 1) / alignment * alignment;
+        ::operator delete(_block, std::align_val_t(alignment));
+        _block = static_cast<unsigned char*>(::operator new(_stride * std::max(_numInstances, std::size_t{1}), std::align_val_t(alignment)));
+        _strings.assign(_numStrings * _numInstances, std::string());
+        for (std::size_t instance=0; instance<_numInstances; ++instance)
+        {
+            for (const auto& slot : _slots)
+            {
+                storeSlot(instance, slot);
+            }
+        }
+
+        return true;
+    }
+
+    void* InstanceState::data(std::size_t instance, const dagbase::Port& port, dagbase::PortType::Type type) const
+    {
+        auto it = _slotIndex.find(&port);
+
+        if (instance >= _numInstances || it == _slotIndex.end() || _slots[it->second].type != type || type == dagbase::PortType::TYPE_STRING)
+        {
+            return nullptr;
+        }
+
+        return cell(instance, _slots[it->second]);
+    }
+
+    std::string* InstanceState::strings(std::size_t instance, const dagbase::Port& port)
+    {
+        auto it = _slotIndex.find(&port);
+
+        if (instance >= _numInstances || it == _slotIndex.end() || _slots[it->second].type != dagbase::PortType::TYPE_STRING)
+        {
+            return nullptr;
+        }
+
+        return &_strings[instance * _numStrings + _slots[it->second].offset];
+    }
+
+    dagbase::Value InstanceState::get(std::size_t instance, const Slot& slot) const
+    {
+        const auto value = cell(instance, slot);
+
+        switch (slot.type)
+        {
+        case dagbase::PortType::TYPE_DOUBLE:
+            return dagbase::Value(*reinterpret_cast<const double*>(value));
+        case dagbase::PortType::TYPE_INT64:
+            return dagbase::Value(*reinterpret_cast<const std::int64_t*>(value));
+        case dagbase::PortType::TYPE_BOOL:
+            return dagbase::Value(*reinterpret_cast<const bool*>(value));
+        default:
+            return dagbase::Value(_strings[instance * _numStrings + slot.offset]);
+        }
+    }
+
+    void InstanceState::set(std::size_t instance, const Slot& slot, const dagbase::Value& value)
+    {
+        const auto dest = cell(instance, slot);
+
+        switch (slot.type)
+        {
+        case dagbase::PortType::TYPE_DOUBLE:
+            *reinterpret_cast<double*>(dest) = value.operator double();
+            break;
+        case dagbase::PortType::TYPE_INT64:
+            *reinterpret_cast<std::int64_t*>(dest) = value.operator std::int64_t();
+            break;
+        case dagbase::PortType::TYPE_BOOL:
+            *reinterpret_cast<bool*>(dest) = value.operator bool();
+            break;
+        default:
+            _strings[instance * _numStrings + slot.offset] = value.operator std::string();
+            break;
+        }
+    }
+
+    void InstanceState::copy(std::size_t instance, const SlotTransfer& transfer)
+    {
+        const auto& dest = _slots[transfer.dest];
+
+        // A source outside the plan, such as the input of a flattened GraphNode, is shared.
+        if (transfer.source == NO_SLOT)
+        {
+            dagbase::ValueVisitor getter;
+            transfer.sourcePort->accept(getter);
+            set(instance, dest, getter.value());
+
+            return;
+        }
+
+        const auto& source = _slots[transfer.source];
+        if (source.type != dest.type)
+        {
+            set(instance, dest, get(instance, source));
+        }
+        else if (source.type == dagbase::PortType::TYPE_STRING)
+        {
+            _strings[instance * _numStrings + dest.offset] = _strings[instance * _numStrings + source.offset];
+        }
+        else
+        {
+            std::memcpy(cell(instance, dest), cell(instance, source), sizeof(double));
+        }
+    }
+
+    void InstanceState::loadSlot(std::size_t instance, const Slot& slot)
+    {
+        const auto value = cell(instance, slot);
+
+        if (slot.doublePort != nullptr)
+        {
+            slot.doublePort->setValue(*reinterpret_cast<const double*>(value));
+        }
+        else if (slot.int64Port != nullptr)
+        {
+            slot.int64Port->setValue(*reinterpret_cast<const std::int64_t*>(value));
+        }
+        else if (slot.boolPort != nullptr)
+        {
+            slot.boolPort->setValue(*reinterpret_cast<const bool*>(value));
+        }
+        else
+        {
+            dagbase::SetValueVisitor setter(get(instance, slot));
+            slot.port->accept(setter);
+        }
+    }
+
+    void InstanceState::storeSlot(std::size_t instance, const Slot& slot)
+    {
+        const auto value = cell(instance, slot);
+
+        if (slot.doublePort != nullptr)
+        {
+            *reinterpret_cast<double*>(value) = slot.doublePort->value();
+        }
+        else if (slot.int64Port != nullptr)
+        {
+            *reinterpret_cast<std::int64_t*>(value) = slot.int64Port->value();
+        }
+        else if (slot.boolPort != nullptr)
+        {
+            *reinterpret_cast<bool*>(value) = slot.boolPort->value();
+        }
+        else
+        {
+            dagbase::ValueVisitor getter;
+            slot.port->accept(getter);
+            set(instance, slot, getter.value());
+        }
+    }
+
+    void InstanceState::load(std::size_t instance, std::size_t index)
+    {
+        for (std::uint32_t t=_firstTransfer[index]; t<_firstTransfer[index + 1]; ++t)
+        {
+            copy(instance, _transfers[t]);
+        }
+        for (std::uint32_t s=_firstSlot[index]; s<_firstSlot[index + 1]; ++s)
+        {
+            loadSlot(instance, _slots[_nodeSlots[s]]);
+        }
+    }
+
+    void InstanceState::store(std::size_t instance, std::size_t index)
+    {
+        for (std::uint32_t s=_firstSlot[index]; s<_firstSlot[index + 1]; ++s)
+        {
+            const auto& slot = _slots[_nodeSlots[s]];
+
+            if (slot.isOutput)
+            {
+                storeSlot(instance, slot);
+            }
+        }
+    }
+
+    void InstanceState::commitFeedback(std::size_t instance)
+    {
+        for (const auto& transfer : _feedback)
+        {
+            copy(instance, transfer);
+        }
+    }
+}
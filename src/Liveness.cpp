@@ -0,0 +1,134 @@
+#include "config/config.h"
+
+#include "Liveness.h"
+#include "EvaluationPlan.h"
+#include "core/Node.h"
+#include "core/Port.h"
+
+#include <algorithm>
+
+namespace dag
+{
+    bool Liveness::pin(dagbase::PortID id)
+    {
+        if (std::find(_pinned.begin(), _pinned.end(), id) != _pinned.end())
+        {
+            return false;
+        }
+
+        _pinned.emplace_back(id);
+
+        return true;
+    }
+
+    bool Liveness::unpin(dagbase::PortID id)
+    {
+        auto it = std::find(_pinned.begin(), _pinned.end(), id);
+        if (it == _pinned.end())
+        {
+            return false;
+        }
+
+        _pinned.erase(it);
+
+        return true;
+    }
+
+    void Liveness::compile(const EvaluationPlan& plan)
+    {
+        const std::size_t n = plan.numNodes();
+
+        _dead.clear();
+        _numLive = std::uint32_t(n);
+        if (!_prune)
+        {
+            return;
+        }
+
+        std::vector<std::uint32_t> stack;
+        std::vector<std::uint8_t> live(n, 0);
+        auto addRoot = [&stack, &live](std::uint32_t index)
+        {
+            if (!live[index])
+            {
+                live[index] = 1;
+                stack.emplace_back(index);
+            }
+        };
+        auto isPinned = [this](const dagbase::Port* port)
+        {
+            return std::find(_pinned.begin(), _pinned.end(), port->id()) != _pinned.end();
+        };
+
+        for (std::size_t i=0; i<n; ++i)
+        {
+            auto node = plan.node(i);
+
+            if (node->category() == dagbase::NodeCategory::CAT_SINK)
+            {
+                addRoot(std::uint32_t(i));
+            }
+            if (_pinned.empty())
+            {
+                continue;
+            }
+            for (std::size_t portIndex=0; portIndex<node->totalPorts(); ++portIndex)
+            {
+                auto port = node->dynamicPort(portIndex);
+
+                if (port != nullptr && isPinned(port))
+                {
+                    addRoot(std::uint32_t(i));
+                }
+            }
+        }
+        // A pinned Port on a flattened Boundary keeps alive whatever produces its value.
+        for (const auto& [port, target] : plan.boundaryIndirection())
+        {
+            if (isPinned(port))
+            {
+                const auto producer = plan.nodeOf(plan.resolve(target));
+                if (producer != EvaluationPlan::NO_NODE)
+                {
+                    addRoot(producer);
+                }
+            }
+        }
+
+        // A live Delay keeps alive whatever feeds it back, which may reach further Nodes.
+        for (bool grown=true; grown;)
+        {
+            while (!stack.empty())
+            {
+                const auto current = stack.back();
+                stack.pop_back();
+                for (std::uint32_t t=plan.beginTransfer(current); t<plan.endTransfer(current); ++t)
+                {
+                    const auto source = plan.sourceNode(t);
+
+                    if (source != EvaluationPlan::NO_NODE)
+                    {
+                        addRoot(source);
+                    }
+                }
+            }
+
+            for (std::size_t f=0; f<plan.numFeedback(); ++f)
+            {
+                if (live[plan.feedbackDest(f)] && plan.feedbackSource(f) != EvaluationPlan::NO_NODE)
+                {
+                    addRoot(plan.feedbackSource(f));
+                }
+            }
+            grown = !stack.empty();
+        }
+
+        _dead.resize(n);
+        _numLive = 0;
+        for (std::size_t i=0; i<n; ++i)
+        {
+            _dead[i] = live[i] ? 0 : 1;
+            _numLive += live[i];
+        }
+    }
+}
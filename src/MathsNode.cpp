@@ -4,8 +4,8 @@
 #include "config/config.h"
 
 #include "MathNode.h"
+#include "BatchContext.h"
 
-#include <cmath>
 
 namespace dag
 {
@@ -110,12 +110,13 @@ namespace dag
     :
     Node(other, facility, copyOp, keyGen)
     {
-        _angle = new dagbase::TypedPort<double>(*other._angle, facility, copyOp, keyGen);
+        _angle = _portStorage.emplace<0>(*other._angle, facility, copyOp, keyGen);
         _angle->setParent(this);
-        _unit = new dagbase::TypedPort<int64_t>(*other._unit, facility, copyOp, keyGen);
+        _unit = _portStorage.emplace<1>(*other._unit, facility, copyOp, keyGen);
         _unit->setParent(this);
-        _output = new dagbase::TypedPort<double>(*other._output, facility, copyOp, keyGen);
+        _output = _portStorage.emplace<2>(*other._output, facility, copyOp, keyGen);
         _output->setParent(this);
+        _accuracy = other._accuracy;
     }
 
     dagbase::OutputStream &MathsNode::writeToStream(dagbase::OutputStream &str, dagbase::NodeLibrary& nodeLib, dagbase::Lua &lua) const
@@ -142,13 +143,27 @@ namespace dag
 
     void MathsNode::update()
     {
-        _output->setValue(std::sin(_angle->value()));
+        _output->setValue(apply(_angle->value()));
+    }
+
+    void MathsNode::updateBatch(BatchContext& context, std::size_t n)
+    {
+        const double* angle = context.doubles(*_angle);
+        double* output = context.doubles(*_output);
+
+        if (angle == nullptr || output == nullptr)
+        {
+            return;
+        }
+
+        // The unit is that of the Node, not of each sample.
+        FastMath::sin(angle, output, n, scale(), _accuracy);
     }
 
     MathsNode::~MathsNode()
     {
-        delete _angle;
-        delete _unit;
-        delete _output;
+        _portStorage.release(_angle);
+        _portStorage.release(_unit);
+        _portStorage.release(_output);
     }
 }
@@ -0,0 +1,129 @@
+#include "config/config.h"
+
+#include "MemoCache.h"
+#include "core/Port.h"
+#include "core/TypedPort.h"
+
+namespace dag
+{
+    namespace
+    {
+        template<typename T>
+        void appendBytes(const T& value, std::string& key)
+        {
+            key.append(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+    }
+
+    MemoCache::MemoCache(std::size_t capacity)
+    :
+    _capacity(capacity)
+    {
+        // Do nothing.
+    }
+
+    bool MemoCache::appendKey(const dagbase::Port& port, std::string& key)
+    {
+        if (auto typed = dynamic_cast<const dagbase::TypedPort<double>*>(&port))
+        {
+            appendBytes(typed->value(), key);
+        }
+        else if (auto typed = dynamic_cast<const dagbase::TypedPort<std::int64_t>*>(&port))
+        {
+            appendBytes(typed->value(), key);
+        }
+        else if (auto typed = dynamic_cast<const dagbase::TypedPort<bool>*>(&port))
+        {
+            appendBytes(typed->value(), key);
+        }
+        else if (auto typed = dynamic_cast<const dagbase::TypedPort<std::string>*>(&port))
+        {
+            // The length keeps consecutive strings from running together.
+            appendBytes(typed->value().size(), key);
+            key.append(typed->value());
+        }
+        else
+        {
+            return false;
+        }
+
+        return true;
+    }
+
+    const MemoCache::ValueArray* MemoCache::lookup(const std::string& key)
+    {
+        auto it = _index.find(key);
+
+        if (it == _index.end())
+        {
+            ++_numMisses;
+
+            return nullptr;
+        }
+
+        ++_numHits;
+        _entries.splice(_entries.begin(), _entries, it->second);
+
+        return &it->second->outputs;
+    }
+
+    void MemoCache::insert(const std::string& key, ValueArray outputs)
+    {
+        if (_capacity == 0)
+        {
+            return;
+        }
+
+        auto it = _index.find(key);
+        if (it != _index.end())
+        {
+            it->second->outputs = std::move(outputs);
+            _entries.splice(_entries.begin(), _entries, it->second);
+
+            return;
+        }
+
+        if (_entries.size() == _capacity)
+        {
+            _index.erase(_entries.back().key);
+            _entries.pop_back();
+            ++_numEvictions;
+        }
+
+        _entries.push_front(Entry{key, std::move(outputs)});
+        _index.emplace(key, _entries.begin());
+    }
+
+    void MemoCache::clear()
+    {
+        _entries.clear();
+        _index.clear();
+    }
+
+    dagbase::Variant MemoCache::find(std::string_view path) const
+    {
+        dagbase::Variant retval;
+
+        retval = dagbase::findEndpoint(path, "size", std::uint32_t(_entries.size()));
+        if (retval.has_value())
+            return retval;
+
+        retval = dagbase::findEndpoint(path, "capacity", std::uint32_t(_capacity));
+        if (retval.has_value())
+            return retval;
+
+        retval = dagbase::findEndpoint(path, "numHits", _numHits);
+        if (retval.has_value())
+            return retval;
+
+        retval = dagbase::findEndpoint(path, "numMisses", _numMisses);
+        if (retval.has_value())
+            return retval;
+
+        retval = dagbase::findEndpoint(path, "numEvictions", _numEvictions);
+        if (retval.has_value())
+            return retval;
+
+        return {};
+    }
+}
@@ -0,0 +1,352 @@
+#include "config/config.h"
+
+#include "Memoisation.h"
+#include "Boundary.h"
+#include "EvaluationPlan.h"
+#include "MemoCache.h"
+#include "core/Graph.h"
+#include "core/GraphNode.h"
+#include "core/Node.h"
+#include "core/Port.h"
+
+#include <algorithm>
+#include <charconv>
+#include <unordered_map>
+
+namespace dag
+{
+    namespace
+    {
+        //! Split name[index].rest into index and rest.
+        bool splitIndex(std::string_view path, std::string_view name, std::uint32_t& index, std::string_view& rest)
+        {
+            if (path.size() <= name.size() + 1 || path.substr(0, name.size()) != name || path[name.size()] != '[')
+            {
+                return false;
+            }
+
+            const char* begin = path.data() + name.size() + 1;
+            const char* end = path.data() + path.size();
+            auto [ptr, ec] = std::from_chars(begin, end, index);
+            if (ec != std::errc() || end - ptr < 2 || ptr[0] != ']' || ptr[1] != '.')
+            {
+                return false;
+            }
+
+            rest = std::string_view(ptr + 2, std::size_t(end - ptr - 2));
+
+            return true;
+        }
+    }
+
+    Memoisation::~Memoisation()
+    {
+        for (auto& setting : _settings)
+        {
+            delete setting.cache;
+        }
+    }
+
+    void Memoisation::setMemoise(dagbase::NodeID graphNode, std::size_t capacity)
+    {
+        auto it = std::find_if(_settings.begin(), _settings.end(), [graphNode](const MemoSetting& setting)
+        {
+            return setting.graphNode == graphNode;
+        });
+
+        if (it != _settings.end())
+        {
+            delete it->cache;
+            _settings.erase(it);
+        }
+        if (capacity != 0)
+        {
+            _settings.emplace_back(MemoSetting{graphNode, new MemoCache(capacity)});
+        }
+    }
+
+    void Memoisation::find(const std::vector<dagbase::Node*>& order, std::unordered_set<const dagbase::Node*>& unflattened)
+    {
+        _memos.clear();
+        if (_settings.empty())
+        {
+            return;
+        }
+
+        for (auto node : order)
+        {
+            auto graphNode = dynamic_cast<dagbase::GraphNode*>(node);
+            if (graphNode == nullptr || graphNode->graph() == nullptr)
+            {
+                continue;
+            }
+
+            auto setting = std::find_if(_settings.begin(), _settings.end(), [graphNode](const MemoSetting& setting)
+            {
+                return setting.graphNode == graphNode->id();
+            });
+            if (setting == _settings.end())
+            {
+                continue;
+            }
+
+            std::unordered_set<const dagbase::Port*> inputs;
+            std::unordered_set<const dagbase::Port*> outputs;
+            for (std::size_t portIndex=0; portIndex<graphNode->totalPorts(); ++portIndex)
+            {
+                if (auto port = graphNode->dynamicPort(portIndex))
+                {
+                    (port->dir() == dagbase::PortDirection::DIR_IN ? inputs : outputs).insert(port);
+                }
+            }
+
+            Memo memo;
+            std::vector<dagbase::Graph*> graphs{graphNode->graph()};
+            while (!graphs.empty())
+            {
+                auto graph = graphs.back();
+                graphs.pop_back();
+                graph->eachNode([&memo, &graphs, &inputs, &outputs](dagbase::Node* child)
+                {
+                    memo.region.emplace_back(child);
+                    if (auto nested = dynamic_cast<dagbase::GraphNode*>(child); nested != nullptr && nested->graph() != nullptr)
+                    {
+                        graphs.emplace_back(nested->graph());
+                    }
+                    if (auto boundary = dynamic_cast<Boundary*>(child))
+                    {
+                        for (std::size_t portIndex=0; portIndex<boundary->totalPorts(); ++portIndex)
+                        {
+                            auto port = boundary->dynamicPort(portIndex);
+
+                            if (inputs.count(port) != 0)
+                            {
+                                memo.input = boundary;
+                            }
+                            else if (outputs.count(port) != 0)
+                            {
+                                memo.output = boundary;
+                            }
+                        }
+                    }
+
+                    return true;
+                });
+            }
+
+            // Without both Boundaries there is no point at which to look up the inputs or save the outputs.
+            if (memo.input == nullptr || memo.output == nullptr)
+            {
+                continue;
+            }
+
+            memo.cache = setting->cache;
+            memo.cache->clear();
+            unflattened.insert(memo.input);
+            unflattened.insert(memo.output);
+            _memos.emplace_back(std::move(memo));
+        }
+    }
+
+    void Memoisation::index(const EvaluationPlan& plan)
+    {
+        const std::size_t n = plan.numNodes();
+
+        _memoEntry.assign(n, NO_MEMO);
+        _memoClose.assign(n, NO_MEMO);
+        _memoOf.assign(n, NO_MEMO);
+        if (_memos.empty())
+        {
+            return;
+        }
+
+        std::unordered_map<const dagbase::Node*, std::uint32_t> nodeIndex;
+        for (std::size_t i=0; i<n; ++i)
+        {
+            nodeIndex.emplace(plan.node(i), std::uint32_t(i));
+        }
+
+        // Claim the largest regions first so that a GraphNode nested in a cached one is evaluated normally.
+        std::sort(_memos.begin(), _memos.end(), [](const Memo& a, const Memo& b)
+        {
+            return a.region.size() > b.region.size();
+        });
+
+        std::vector<Memo> memos;
+        std::vector<std::uint8_t> inRegion(n, 0);
+        IndexArray stack;
+        for (auto& memo : _memos)
+        {
+            auto entry = nodeIndex.find(memo.input);
+            auto exit = nodeIndex.find(memo.output);
+            if (entry == nodeIndex.end() || exit == nodeIndex.end() || _memoOf[entry->second] != NO_MEMO)
+            {
+                continue;
+            }
+
+            const auto index = std::uint32_t(memos.size());
+            memo.entry = entry->second;
+            memo.exit = exit->second;
+            memo.close = std::max(memo.entry, memo.exit);
+            _memoEntry[memo.entry] = index;
+            _memoClose[memo.close] = index;
+
+            // Only the Nodes that depend on the inputs are skipped on a hit, the others always run.
+            std::fill(inRegion.begin(), inRegion.end(), 0);
+            for (auto node : memo.region)
+            {
+                auto it = nodeIndex.find(node);
+                if (it != nodeIndex.end())
+                {
+                    inRegion[it->second] = 1;
+                }
+            }
+            stack.assign(1, memo.entry);
+            while (!stack.empty())
+            {
+                const auto current = stack.back();
+                stack.pop_back();
+                for (auto successor = plan.beginSuccessors(current); successor != plan.endSuccessors(current); ++successor)
+                {
+                    if (inRegion[*successor] != 0 && _memoOf[*successor] == NO_MEMO)
+                    {
+                        _memoOf[*successor] = index;
+                        stack.emplace_back(*successor);
+                    }
+                }
+            }
+            memos.emplace_back(std::move(memo));
+        }
+        _memos = std::move(memos);
+    }
+
+    void Memoisation::beginFrame()
+    {
+        for (auto& memo : _memos)
+        {
+            memo.hit = false;
+        }
+    }
+
+    void Memoisation::afterNode(std::size_t index)
+    {
+        if (_memoEntry[index] != NO_MEMO)
+        {
+            beginMemo(_memoEntry[index]);
+        }
+        // An exit that does not depend on the inputs may sort before the entry, then the entry closes.
+        if (_memoClose[index] != NO_MEMO)
+        {
+            endMemo(_memoClose[index]);
+        }
+    }
+
+    void Memoisation::beginMemo(std::uint32_t index)
+    {
+        auto& memo = _memos[index];
+
+        memo.key.clear();
+        memo.cacheable = true;
+        for (std::size_t portIndex=0; portIndex<memo.input->totalPorts() && memo.cacheable; ++portIndex)
+        {
+            auto port = memo.input->dynamicPort(portIndex);
+
+            if (port != nullptr && port->dir() == dagbase::PortDirection::DIR_IN)
+            {
+                memo.cacheable = MemoCache::appendKey(*port, memo.key);
+            }
+        }
+
+        if (!memo.cacheable)
+        {
+            return;
+        }
+
+        auto outputs = memo.cache->lookup(memo.key);
+        if (outputs == nullptr)
+        {
+            return;
+        }
+
+        std::size_t next = 0;
+        for (std::size_t portIndex=0; portIndex<memo.output->totalPorts(); ++portIndex)
+        {
+            auto port = memo.output->dynamicPort(portIndex);
+
+            if (port != nullptr && port->dir() == dagbase::PortDirection::DIR_OUT && next < outputs->size())
+            {
+                dagbase::SetValueVisitor setter((*outputs)[next++]);
+                port->accept(setter);
+            }
+        }
+        memo.hit = true;
+    }
+
+    void Memoisation::endMemo(std::uint32_t index)
+    {
+        auto& memo = _memos[index];
+
+        // A hit restored the outputs from the cache already.
+        if (!memo.cacheable || memo.hit)
+        {
+            return;
+        }
+
+        MemoCache::ValueArray outputs;
+        for (std::size_t portIndex=0; portIndex<memo.output->totalPorts(); ++portIndex)
+        {
+            auto port = memo.output->dynamicPort(portIndex);
+
+            if (port != nullptr && port->dir() == dagbase::PortDirection::DIR_OUT)
+            {
+                dagbase::ValueVisitor getter;
+                port->accept(getter);
+                outputs.emplace_back(getter.value());
+            }
+        }
+        memo.cache->insert(memo.key, std::move(outputs));
+    }
+
+    std::uint32_t Memoisation::numHits() const
+    {
+        std::uint32_t numHits = 0;
+
+        for (const auto& setting : _settings)
+        {
+            numHits += setting.cache->numHits();
+        }
+
+        return numHits;
+    }
+
+    std::uint32_t Memoisation::numMisses() const
+    {
+        std::uint32_t numMisses = 0;
+
+        for (const auto& setting : _settings)
+        {
+            numMisses += setting.cache->numMisses();
+        }
+
+        return numMisses;
+    }
+
+    dagbase::Variant Memoisation::find(std::string_view path) const
+    {
+        std::uint32_t id = 0;
+        std::string_view rest;
+
+        if (splitIndex(path, "memos", id, rest))
+        {
+            for (const auto& setting : _settings)
+            {
+                if (setting.graphNode == dagbase::NodeID(id))
+                {
+                    return setting.cache->find(rest);
+                }
+            }
+        }
+
+        return {};
+    }
+}
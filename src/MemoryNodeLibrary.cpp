@@ -12,6 +12,7 @@
 #include "Nodes.h"
 #include "Boundary.h"
 #include "MathNode.h"
+#include "Delay.h"
 
 #include <cstring>
 
@@ -32,6 +33,7 @@ namespace dag
         _classes.emplace("Boundary", new Boundary(*this, "b1", dagbase::NodeCategory::CAT_GROUP));
         _classes.emplace("MathsNode", new MathsNode(*this, "maths1", dagbase::NodeCategory::CAT_ACTION));
         _classes.emplace("GraphNode", new dagbase::GraphNode(*this, "graph1", dagbase::NodeCategory::CAT_GROUP));
+        _classes.emplace("Delay", new Delay(*this, "delay1", dagbase::NodeCategory::CAT_SOURCE));
     }
 
     MemoryNodeLibrary::~MemoryNodeLibrary()
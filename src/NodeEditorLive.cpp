@@ -9,6 +9,14 @@
 #include <set>
 
 #include "MemoryNodeLibrary.h"
+#include "EvaluationPlan.h"
+#include "DataflowExecutor.h"
+#include "EvaluationProfile.h"
+#include "InstanceState.h"
+#include "EvaluationCursor.h"
+#include "BatchContext.h"
+#include "ThreadPool.h"
+#include "TopologicalOrder.h"
 #include "core/Graph.h"
 #include "SelectionLive.h"
 #include "Boundary.h"
@@ -30,6 +38,12 @@ namespace dag
         _graph->setNodeLibrary(_nodeLib);
         _activeGraph = _graph;
         _selection = new SelectionLive();
+        _plan = new EvaluationPlan();
+        _dataflow = new DataflowExecutor();
+        _batch = new BatchContext();
+        _order = new TopologicalOrder();
+        _instances = new InstanceState();
+        _cursor = new EvaluationCursor();
     }
 
     NodeEditorLive::~NodeEditorLive()
@@ -38,10 +52,16 @@ namespace dag
         delete _graph;
         // The active graph is a reference to somewhere in the tree of Graph we just deleted.
         delete _selection;
-        for (auto transfer : _transfers)
-        {
-            delete transfer;
-        }
+        delete _plan;
+        delete _threadPool;
+        delete _dataflow;
+        delete _batch;
+        delete _order;
+        delete _profile;
+        delete _costs;
+        delete _instances;
+        delete _cursor;
+        clearTransfers();
     }
 
     dagbase::Status NodeEditorLive::setActiveGraph(const GraphChildPath &path)
@@ -71,6 +91,9 @@ namespace dag
             delete _graph;
             _graph = g;
             _activeGraph = _graph;
+            clearTransfers();
+            _plan->invalidate();
+            _order->invalidate();
         }
 
         return status;
@@ -169,6 +192,8 @@ namespace dag
                 status.result = node->id();
                 // Add the node to the active Graph
                 _activeGraph->addNode(node);
+                _order->addNode(node);
+                _plan->invalidate();
 
                 return status;
             }
@@ -185,8 +210,23 @@ namespace dag
 
             if (node != nullptr)
             {
+                // Delete the Transfers of the SignalPaths that go with the Node.
+                std::vector<dagbase::SignalPathID> paths;
+                _activeGraph->eachSignalPath([node, &paths](dagbase::SignalPath* signalPath) {
+                    if (signalPath->sourceNode() == node || signalPath->destNode() == node)
+                    {
+                        paths.emplace_back(signalPath->id());
+                    }
+                    return true;
+                });
                 _activeGraph->deleteNode(node);
+                for (auto path : paths)
+                {
+                    releaseTransfer(path);
+                }
+                _order->removeNode(node);
                 delete node;
+                _plan->invalidate();
                 status.status = dagbase::Status::STATUS_OK;
                 status.resultType = dagbase::Status::RESULT_NODE_ID;
                 status.result = id;
@@ -226,17 +266,51 @@ namespace dag
                 bool isCompatible = fromPort->isCompatibleWith(*toPort);
                 if (fromPort->dir() == dagbase::PortDirection::DIR_OUT && toPort->dir() == dagbase::PortDirection::DIR_IN && isCompatible)
                 {
+                    if (!_order->isValid())
+                    {
+                        _order->rebuild(*_graph);
+                    }
+
+                    // Reject a connection that would close a cycle before making it.
+                    const bool tracked = _order->isValid();
+                    if (tracked && !_order->addEdge(*fromPort, *toPort))
+                    {
+                        auto status = dagbase::Status{ dagbase::Status::STATUS_CYCLE_DETECTED };
+                        status.resultType = dagbase::Status::RESULT_NODE_ID;
+                        status.result = fromPort->parent()->id();
+                        return status;
+                    }
+
                     auto transfer = fromPort->connectTo(*toPort);
                     auto signalPath = new dagbase::SignalPath(*_graph, fromPort, toPort);
 
                     _activeGraph->addSignalPath(signalPath);
 
+                    // Without an order the Graph could not be sorted before, so sort it again with
+                    // the connection, treating the connections into a Delay as addEdge() does.
+                    if (!tracked)
+                    {
+                        _order->rebuild(*_graph);
+                    }
+                    if (!_order->isValid())
+                    {
+                        fromPort->disconnect(*toPort);
+                        _activeGraph->deleteSignalPath(signalPath);
+                        delete transfer;
+
+                        auto status = dagbase::Status{ dagbase::Status::STATUS_CYCLE_DETECTED };
+                        status.resultType = dagbase::Status::RESULT_NODE_ID;
+                        status.result = fromPort->parent()->id();
+                        return status;
+                    }
+
                     dagbase::Status status{dagbase::Status::STATUS_UNKNOWN};
 
                     status.status = dagbase::Status::STATUS_OK;
                     status.resultType = dagbase::Status::RESULT_SIGNAL_PATH_ID;
                     status.result = signalPath->id();
-                    _transfers.emplace_back(transfer);
+                    _transfers.emplace(std::uint32_t(signalPath->id()), transfer);
+                    _plan->invalidate();
 
                     return status;
                 }
@@ -301,6 +375,8 @@ namespace dag
             {
                 path->source()->disconnect(*path->dest());
                 _activeGraph->deleteSignalPath(path);
+                releaseTransfer(id);
+                _plan->invalidate();
                 status.status = dagbase::Status::STATUS_OK;
             }
             else
@@ -477,6 +553,8 @@ namespace dag
                         }
                     }
                     _activeGraph->addNode(graphNode);
+                    _plan->invalidate();
+                    _order->invalidate();
                     status.status = dagbase::Status::STATUS_OK;
                     status.resultType = dagbase::Status::RESULT_NODE_ID;
                     status.result = graphNode->id();
@@ -504,6 +582,8 @@ namespace dag
                 const NodeArray& internals = _selection->internals();
                 dagbase::CloningFacility facility;
                 status = _activeGraph->cloneNodes(internals, *_activeGraph, facility, *_graph);
+                _plan->invalidate();
+                _order->invalidate();
             }
 
             return status;
@@ -656,11 +736,405 @@ namespace dag
         _graph = new dagbase::Graph(str, *_nodeLib, lua);
         _graph->adjustNextID();
         _activeGraph = _graph;
+        clearTransfers();
+        _plan->invalidate();
+        _order->invalidate();
         status.status = dagbase::Status::STATUS_OK;
 
         return status;
     }
 
+    void NodeEditorLive::releaseTransfer(dagbase::SignalPathID id)
+    {
+        auto it = _transfers.find(std::uint32_t(id));
+
+        if (it != _transfers.end())
+        {
+            delete it->second;
+            _transfers.erase(it);
+        }
+    }
+
+    void NodeEditorLive::clearTransfers()
+    {
+        for (auto& entry : _transfers)
+        {
+            delete entry.second;
+        }
+        _transfers.clear();
+    }
+
+    dagbase::Status NodeEditorLive::compilePlan()
+    {
+        if (!_order->isValid())
+        {
+            _order->rebuild(*_graph);
+        }
+
+        auto status = _plan->compile(*_graph, _order);
+        const EvaluationProfile* costs = _profile != nullptr ? _profile : _costs;
+
+        // Timings are found by id, so those of the previous compile still apply.
+        if (status.status == dagbase::Status::STATUS_OK && costs != nullptr)
+        {
+            _plan->weighCriticalPath(costs);
+        }
+
+        return status;
+    }
+
+    dagbase::Status NodeEditorLive::evaluate()
+    {
+        if (_graph == nullptr)
+        {
+            return dagbase::Status{dagbase::Status::STATUS_OBJECT_NOT_FOUND};
+        }
+
+        if (!_plan->isValid())
+        {
+            auto status = compilePlan();
+
+            if (status.status != dagbase::Status::STATUS_OK)
+            {
+                return status;
+            }
+        }
+
+        if (_profile != nullptr)
+        {
+            _plan->evaluate(*_profile);
+        }
+        else if (_threadPool != nullptr && _scheduler != EvaluationPlan::SCHEDULER_LEVELS)
+        {
+            _dataflow->setCriticalPathFirst(_scheduler == EvaluationPlan::SCHEDULER_CRITICAL_PATH);
+            _dataflow->evaluate(*_plan, *_threadPool);
+        }
+        else if (_threadPool != nullptr)
+        {
+            _plan->evaluateParallel(*_threadPool);
+        }
+        else
+        {
+            _plan->evaluate();
+        }
+        _plan->clearDirty();
+
+        return dagbase::Status{dagbase::Status::STATUS_OK};
+    }
+
+    dagbase::Status NodeEditorLive::evaluateDirty()
+    {
+        if (_graph == nullptr)
+        {
+            return dagbase::Status{dagbase::Status::STATUS_OBJECT_NOT_FOUND};
+        }
+
+        if (!_plan->isValid())
+        {
+            auto status = compilePlan();
+
+            if (status.status != dagbase::Status::STATUS_OK)
+            {
+                return status;
+            }
+        }
+
+        _plan->evaluateDirty();
+
+        return dagbase::Status{dagbase::Status::STATUS_OK};
+    }
+
+    dagbase::Status NodeEditorLive::evaluateFor(dagbase::PortID id)
+    {
+        if (_graph == nullptr || _activeGraph == nullptr)
+        {
+            return dagbase::Status{dagbase::Status::STATUS_OBJECT_NOT_FOUND};
+        }
+
+        auto port = _activeGraph->port(id);
+        if (port == nullptr)
+        {
+            return dagbase::Status{dagbase::Status::STATUS_OBJECT_NOT_FOUND};
+        }
+
+        if (!_plan->isValid())
+        {
+            auto status = compilePlan();
+
+            if (status.status != dagbase::Status::STATUS_OK)
+            {
+                return status;
+            }
+        }
+
+        if (!_plan->evaluateFor(*port))
+        {
+            return dagbase::Status{dagbase::Status::STATUS_OBJECT_NOT_FOUND};
+        }
+
+        return dagbase::Status{dagbase::Status::STATUS_OK};
+    }
+
+    dagbase::Status NodeEditorLive::prepareBatch(std::size_t n)
+    {
+        if (_graph == nullptr)
+        {
+            return dagbase::Status{dagbase::Status::STATUS_OBJECT_NOT_FOUND};
+        }
+
+        if (!_plan->isValid())
+        {
+            auto status = compilePlan();
+
+            if (status.status != dagbase::Status::STATUS_OK)
+            {
+                return status;
+            }
+        }
+
+        _plan->prepareBatch(*_batch, n);
+
+        return dagbase::Status{dagbase::Status::STATUS_OK};
+    }
+
+    dagbase::Status NodeEditorLive::evaluateBatch()
+    {
+        if (!_plan->isValid() || !_plan->isBatchPrepared())
+        {
+            return dagbase::Status{dagbase::Status::STATUS_OBJECT_NOT_FOUND};
+        }
+
+        _plan->evaluateBatch();
+
+        return dagbase::Status{dagbase::Status::STATUS_OK};
+    }
+
+    double* NodeEditorLive::batchDoubles(dagbase::PortID id)
+    {
+        auto port = _activeGraph != nullptr ? _activeGraph->port(id) : nullptr;
+
+        return port != nullptr ? _batch->doubles(*port) : nullptr;
+    }
+
+    std::int64_t* NodeEditorLive::batchInt64s(dagbase::PortID id)
+    {
+        auto port = _activeGraph != nullptr ? _activeGraph->port(id) : nullptr;
+
+        return port != nullptr ? _batch->int64s(*port) : nullptr;
+    }
+
+    dagbase::Status NodeEditorLive::prepareInstances(std::size_t n)
+    {
+        if (_graph == nullptr)
+        {
+            return dagbase::Status{dagbase::Status::STATUS_OBJECT_NOT_FOUND};
+        }
+
+        if (!_plan->isValid())
+        {
+            auto status = compilePlan();
+
+            if (status.status != dagbase::Status::STATUS_OK)
+            {
+                return status;
+            }
+        }
+
+        if (!_plan->prepareInstances(*_instances, n))
+        {
+            return dagbase::Status{dagbase::Status::STATUS_INVALID_PORT};
+        }
+
+        return dagbase::Status{dagbase::Status::STATUS_OK};
+    }
+
+    dagbase::Status NodeEditorLive::evaluateInstances()
+    {
+        if (!_plan->isValid() || !_plan->isInstancesPrepared())
+        {
+            return dagbase::Status{dagbase::Status::STATUS_OBJECT_NOT_FOUND};
+        }
+
+        _plan->evaluateInstances();
+
+        return dagbase::Status{dagbase::Status::STATUS_OK};
+    }
+
+    dagbase::Status NodeEditorLive::evaluateWithin(std::chrono::nanoseconds budget, bool& finished)
+    {
+        finished = false;
+        if (_graph == nullptr)
+        {
+            return dagbase::Status{dagbase::Status::STATUS_OBJECT_NOT_FOUND};
+        }
+
+        if (!_plan->isValid())
+        {
+            auto status = compilePlan();
+
+            if (status.status != dagbase::Status::STATUS_OK)
+            {
+                return status;
+            }
+        }
+
+        finished = _cursor->evaluate(*_plan, budget);
+        if (finished)
+        {
+            _plan->clearDirty();
+        }
+
+        return dagbase::Status{dagbase::Status::STATUS_OK};
+    }
+
+    void NodeEditorLive::setSnapshot(bool snapshot)
+    {
+        _cursor->setSnapshot(snapshot);
+    }
+
+    const double* NodeEditorLive::snapshotDoubles(dagbase::PortID id) const
+    {
+        auto port = _activeGraph != nullptr ? _activeGraph->port(id) : nullptr;
+        auto snapshot = _cursor->snapshot();
+
+        return port != nullptr && snapshot != nullptr ? snapshot->doubles(0, *port) : nullptr;
+    }
+
+    const std::int64_t* NodeEditorLive::snapshotInt64s(dagbase::PortID id) const
+    {
+        auto port = _activeGraph != nullptr ? _activeGraph->port(id) : nullptr;
+        auto snapshot = _cursor->snapshot();
+
+        return port != nullptr && snapshot != nullptr ? snapshot->int64s(0, *port) : nullptr;
+    }
+
+    double* NodeEditorLive::instanceDoubles(std::size_t instance, dagbase::PortID id)
+    {
+        auto port = _activeGraph != nullptr ? _activeGraph->port(id) : nullptr;
+
+        return port != nullptr ? _instances->doubles(instance, *port) : nullptr;
+    }
+
+    std::int64_t* NodeEditorLive::instanceInt64s(std::size_t instance, dagbase::PortID id)
+    {
+        auto port = _activeGraph != nullptr ? _activeGraph->port(id) : nullptr;
+
+        return port != nullptr ? _instances->int64s(instance, *port) : nullptr;
+    }
+
+    bool* NodeEditorLive::instanceBools(std::size_t instance, dagbase::PortID id)
+    {
+        auto port = _activeGraph != nullptr ? _activeGraph->port(id) : nullptr;
+
+        return port != nullptr ? _instances->bools(instance, *port) : nullptr;
+    }
+
+    std::string* NodeEditorLive::instanceStrings(std::size_t instance, dagbase::PortID id)
+    {
+        auto port = _activeGraph != nullptr ? _activeGraph->port(id) : nullptr;
+
+        return port != nullptr ? _instances->strings(instance, *port) : nullptr;
+    }
+
+    dagbase::Status NodeEditorLive::setValue(dagbase::PortID id, const dagbase::Value& value)
+    {
+        if (_activeGraph == nullptr)
+        {
+            return dagbase::Status{dagbase::Status::STATUS_OBJECT_NOT_FOUND};
+        }
+
+        auto port = _activeGraph->port(id);
+        if (port == nullptr)
+        {
+            return dagbase::Status{dagbase::Status::STATUS_OBJECT_NOT_FOUND};
+        }
+
+        dagbase::SetValueVisitor setter(value);
+        port->accept(setter);
+        _plan->markDirty(*port);
+
+        return dagbase::Status{dagbase::Status::STATUS_OK};
+    }
+
+    dagbase::Status NodeEditorLive::setMemoise(dagbase::NodeID id, std::size_t capacity)
+    {
+        auto node = _activeGraph != nullptr ? _activeGraph->node(id) : nullptr;
+
+        if (dynamic_cast<dagbase::GraphNode*>(node) == nullptr)
+        {
+            return dagbase::Status{dagbase::Status::STATUS_OBJECT_NOT_FOUND};
+        }
+
+        _plan->setMemoise(id, capacity);
+
+        return dagbase::Status{dagbase::Status::STATUS_OK};
+    }
+
+    dagbase::Status NodeEditorLive::setDivisor(dagbase::NodeID id, std::uint32_t divisor)
+    {
+        if (_activeGraph == nullptr || _activeGraph->node(id) == nullptr)
+        {
+            return dagbase::Status{dagbase::Status::STATUS_OBJECT_NOT_FOUND};
+        }
+
+        _plan->setDivisor(id, divisor);
+
+        return dagbase::Status{dagbase::Status::STATUS_OK};
+    }
+
+    dagbase::Status NodeEditorLive::pinPort(dagbase::PortID id)
+    {
+        if (_activeGraph == nullptr || _activeGraph->port(id) == nullptr)
+        {
+            return dagbase::Status{dagbase::Status::STATUS_OBJECT_NOT_FOUND};
+        }
+
+        _plan->pin(id);
+
+        return dagbase::Status{dagbase::Status::STATUS_OK};
+    }
+
+    dagbase::Status NodeEditorLive::unpinPort(dagbase::PortID id)
+    {
+        if (_activeGraph == nullptr || _activeGraph->port(id) == nullptr)
+        {
+            return dagbase::Status{dagbase::Status::STATUS_OBJECT_NOT_FOUND};
+        }
+
+        _plan->unpin(id);
+
+        return dagbase::Status{dagbase::Status::STATUS_OK};
+    }
+
+    void NodeEditorLive::setProfiling(bool profiling)
+    {
+        if (profiling && _profile == nullptr)
+        {
+            _profile = new EvaluationProfile();
+        }
+        else if (!profiling && _profile != nullptr)
+        {
+            // Keep the timings as the costs of SCHEDULER_CRITICAL_PATH.
+            delete _costs;
+            _costs = _profile;
+            _profile = nullptr;
+            if (_plan->isValid())
+            {
+                _plan->weighCriticalPath(_costs);
+            }
+        }
+    }
+
+    void NodeEditorLive::setNumThreads(std::size_t numThreads)
+    {
+        delete _threadPool;
+        _threadPool = nullptr;
+        if (numThreads != 1)
+        {
+            _threadPool = new ThreadPool(numThreads);
+        }
+    }
+
     void NodeEditorLive::debug()
     {
         if (_graph)
@@ -686,6 +1160,37 @@ namespace dag
         if (retval.has_value())
             return retval;
 
+        retval = dagbase::findInternal(path, "plan", _plan);
+        if (retval.has_value())
+            return retval;
+
+        retval = dagbase::findInternal(path, "order", _order);
+        if (retval.has_value())
+            return retval;
+
+        retval = dagbase::findEndpoint(path, "numTransfers", std::uint32_t(_transfers.size()));
+        if (retval.has_value())
+            return retval;
+
+        retval = dagbase::findInternal(path, "cursor", _cursor);
+        if (retval.has_value())
+            return retval;
+
+        if (_profile)
+        {
+            retval = dagbase::findInternal(path, "profile", _profile);
+            if (retval.has_value())
+                return retval;
+        }
+
+        retval = dagbase::findEndpoint(path, "numInstances", std::uint32_t(_plan->isInstancesPrepared() ? _instances->numInstances() : 0));
+        if (retval.has_value())
+            return retval;
+
+        retval = dagbase::findEndpoint(path, "numThreads", std::uint32_t(_threadPool != nullptr ? _threadPool->numThreads() : 1));
+        if (retval.has_value())
+            return retval;
+
         if (_nodeLib)
         {
             retval = dagbase::findInternal(path, "nodeLib", _nodeLib);
@@ -14,21 +14,30 @@ namespace dag
                     dagbase::MetaPort{dagbase::MetaPort::FLAGS_OWN_BIT}
             };
 
+    // The table of a class copies that of its base class, so it is defined after it.
+    const PortTable<1> Base::portTable(declarePort<&Base::_direction>(ports[0]));
+
     std::array<dagbase::MetaPort, 1> Derived::ports =
             {
                     dagbase::MetaPort(dagbase::MetaPort::FLAGS_OWN_BIT)
             };
 
+    const PortTable<2> Derived::portTable(Base::portTable, declarePort<&Derived::_trigger>(ports[0]));
+
     std::array<dagbase::MetaPort, 1> Final::ports=
             {
                     dagbase::MetaPort(dagbase::MetaPort::FLAGS_OWN_BIT)
             };
 
+    const PortTable<3> Final::portTable(Derived::portTable, declarePort<&Final::_int1>(ports[0]));
+
     std::array<dagbase::MetaPort, 1> FooTyped::ports =
             {
                     dagbase::MetaPort(dagbase::MetaPort::FLAGS_OWN_BIT)
             };
 
+    const PortTable<1> FooTyped::portTable(declarePort<&FooTyped::_in1>(ports[0]));
+
     FooTyped *FooTyped::create(dagbase::InputStream &str, dagbase::NodeLibrary &nodeLib, dagbase::Lua &lua)
     {
         return new FooTyped(str, nodeLib, lua);
@@ -36,7 +45,7 @@ namespace dag
 
     FooTyped::FooTyped(dagbase::InputStream &str, dagbase::NodeLibrary &nodeLib, dagbase::Lua &lua)
             :
-            Node()
+            PortTableNode()
 
     {
         std::string className;
@@ -108,7 +117,7 @@ namespace dag
 
     FooTyped::~FooTyped()
     {
-        delete _in1;
+        _portStorage.release(_in1);
     }
 
     std::array<dagbase::MetaPort, 1> BarTyped::ports =
@@ -116,6 +125,8 @@ namespace dag
                     dagbase::MetaPort(dagbase::MetaPort::FLAGS_OWN_BIT)
             };
 
+    const PortTable<1> BarTyped::portTable(declarePort<&BarTyped::_out1>(ports[0]));
+
     BarTyped *BarTyped::create(dagbase::InputStream &str, dagbase::NodeLibrary &nodeLib, dagbase::Lua &lua)
     {
         return new BarTyped(str, nodeLib, lua);
@@ -123,7 +134,7 @@ namespace dag
 
     BarTyped::BarTyped(dagbase::InputStream &str, dagbase::NodeLibrary &nodeLib, dagbase::Lua &lua)
             :
-            Node()
+            PortTableNode()
     {
         std::string className;
         std::string fieldName;
@@ -193,7 +204,7 @@ namespace dag
 
     BarTyped::~BarTyped()
     {
-        delete _out1;
+        _portStorage.release(_out1);
     }
 
     std::array<dagbase::MetaPort, 2> GroupTyped::ports =
@@ -202,9 +213,11 @@ namespace dag
                     dagbase::MetaPort(dagbase::MetaPort::FLAGS_OWN_BIT)
             };
 
+    const PortTable<2> GroupTyped::portTable(declarePort<&GroupTyped::_out1>(ports[0]), declarePort<&GroupTyped::_in1>(ports[1]));
+
     GroupTyped::GroupTyped(dagbase::InputStream &str, dagbase::NodeLibrary &nodeLib, dagbase::Lua &lua)
             :
-            Node()
+            PortTableNode()
     {
         std::string className;
 
@@ -247,8 +260,8 @@ namespace dag
 
     GroupTyped::~GroupTyped()
     {
-        delete _out1;
-        delete _in1;
+        _portStorage.release(_out1);
+        _portStorage.release(_in1);
     }
 
     GroupTyped *GroupTyped::create(dagbase::InputStream &str, dagbase::NodeLibrary &nodeLib, dagbase::Lua &lua)
@@ -317,7 +330,7 @@ namespace dag
 
     Base::Base(const Base& other, dagbase::CloningFacility& facility, dagbase::CopyOp copyOp, dagbase::KeyGenerator* keyGen)
         :
-        Node(other, facility, copyOp, keyGen),
+        PortTableNode(other, facility, copyOp, keyGen),
         int1(other.int1)
     {
         std::uint64_t directionId = 0;
@@ -334,7 +347,7 @@ namespace dag
 
     Base::Base(dagbase::InputStream& str, dagbase::NodeLibrary& nodeLib, dagbase::Lua& lua)
         :
-        Node(),
+        PortTableNode(),
         int1(0.0)
     {
         Base::readFromStream(str, nodeLib, lua);
@@ -406,7 +419,7 @@ namespace dag
 
     Derived::Derived(const Derived& other, dagbase::CloningFacility& facility, dagbase::CopyOp copyOp, dagbase::KeyGenerator* keyGen)
         :
-        Base(other, facility, copyOp, keyGen)
+        PortTableNode(other, facility, copyOp, keyGen)
     {
         std::uint64_t triggerId = 0;
         if (facility.putOrig(other._trigger, &triggerId))
@@ -422,7 +435,7 @@ namespace dag
 
     Derived::Derived(dagbase::InputStream& str, dagbase::NodeLibrary& nodeLib, dagbase::Lua& lua)
         :
-        Base()
+        PortTableNode()
     {
         Derived::readFromStream(str, nodeLib, lua);
     }
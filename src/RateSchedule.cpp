@@ -0,0 +1,96 @@
+#include "config/config.h"
+
+#include "RateSchedule.h"
+#include "EvaluationPlan.h"
+#include "core/Node.h"
+
+#include <algorithm>
+#include <iterator>
+#include <unordered_map>
+
+namespace dag
+{
+    void RateSchedule::setDivisor(dagbase::NodeID id, std::uint32_t divisor)
+    {
+        auto it = std::find_if(_settings.begin(), _settings.end(), [id](const RateSetting& setting)
+        {
+            return setting.node == id;
+        });
+
+        if (it != _settings.end())
+        {
+            _settings.erase(it);
+        }
+        if (divisor > 1)
+        {
+            _settings.emplace_back(RateSetting{id, divisor});
+        }
+    }
+
+    void RateSchedule::compile(const EvaluationPlan& plan)
+    {
+        _rates.clear();
+        _nodesOfRate.clear();
+        _everyTick.clear();
+        _rateOf.clear();
+        _rateDue.clear();
+        _due.clear();
+        _numNodes = std::uint32_t(plan.numNodes());
+        if (_settings.empty())
+        {
+            return;
+        }
+
+        std::unordered_map<std::uint32_t, std::uint32_t> divisorOf;
+        for (const auto& setting : _settings)
+        {
+            _rates.emplace_back(setting.divisor);
+            divisorOf.emplace(std::uint32_t(setting.node), setting.divisor);
+        }
+        std::sort(_rates.begin(), _rates.end());
+        _rates.erase(std::unique(_rates.begin(), _rates.end()), _rates.end());
+
+        _nodesOfRate.resize(_rates.size());
+        _rateDue.assign(_rates.size(), 0);
+        _rateOf.assign(_numNodes, NO_RATE);
+        // Visiting in plan order leaves every bucket sorted, ready to be merged.
+        for (std::uint32_t i=0; i<_numNodes; ++i)
+        {
+            auto it = divisorOf.find(std::uint32_t(plan.node(i)->id()));
+
+            if (it == divisorOf.end())
+            {
+                _everyTick.emplace_back(i);
+                continue;
+            }
+
+            const auto rate = std::uint32_t(std::lower_bound(_rates.begin(), _rates.end(), it->second) - _rates.begin());
+            _rateOf[i] = rate;
+            _nodesOfRate[rate].emplace_back(i);
+        }
+        _due.reserve(_numNodes);
+        _merged.reserve(_numNodes);
+    }
+
+    void RateSchedule::beginFrame()
+    {
+        if (_rates.empty())
+        {
+            return;
+        }
+
+        _due.assign(_everyTick.begin(), _everyTick.end());
+        for (std::size_t r=0; r<_rates.size(); ++r)
+        {
+            _rateDue[r] = _tick % _rates[r] == 0 ? 1 : 0;
+            if (_rateDue[r] == 0 || _nodesOfRate[r].empty())
+            {
+                continue;
+            }
+
+            _merged.clear();
+            std::merge(_due.begin(), _due.end(), _nodesOfRate[r].begin(), _nodesOfRate[r].end(), std::back_inserter(_merged));
+            _due.swap(_merged);
+        }
+    }
+}
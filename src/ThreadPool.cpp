@@ -0,0 +1,117 @@
+#include "config/config.h"
+
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+namespace dag
+{
+    ThreadPool::ThreadPool(std::size_t numThreads)
+    {
+        if (numThreads == 0)
+        {
+            numThreads = std::max(1U, std::thread::hardware_concurrency());
+        }
+
+        _workers.reserve(numThreads - 1);
+        for (std::size_t i=1; i<numThreads; ++i)
+        {
+            _workers.emplace_back(&ThreadPool::workerLoop, this);
+        }
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+        _start.notify_all();
+        for (auto& worker : _workers)
+        {
+            worker.join();
+        }
+    }
+
+    void ThreadPool::run(std::size_t count, Task task, void* context)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+
+        if (_workers.empty())
+        {
+            for (std::size_t i=0; i<count; ++i)
+            {
+                task(context, i);
+            }
+
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _task = task;
+            _context = context;
+            _count = count;
+            // Several chunks per thread so that uneven Nodes still balance.
+            _grain = std::max(std::size_t{1}, count / (numThreads() * 4));
+            _next.store(0, std::memory_order_relaxed);
+            _busy = _workers.size();
+            ++_generation;
+        }
+        _start.notify_all();
+        drain();
+
+        std::unique_lock<std::mutex> lock(_mutex);
+        _done.wait(lock, [this] { return _busy == 0; });
+    }
+
+    void ThreadPool::workerLoop()
+    {
+        std::uint64_t seen = 0;
+
+        for (;;)
+        {
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _start.wait(lock, [this, seen] { return _stop || _generation != seen; });
+                if (_stop)
+                {
+                    return;
+                }
+                seen = _generation;
+            }
+
+            drain();
+
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                if (--_busy == 0)
+                {
+                    _done.notify_one();
+                }
+            }
+        }
+    }
+
+    void ThreadPool::drain()
+    {
+        for (;;)
+        {
+            const std::size_t begin = _next.fetch_add(_grain, std::memory_order_relaxed);
+
+            if (begin >= _count)
+            {
+                break;
+            }
+
+            const std::size_t end = std::min(begin + _grain, _count);
+            for (std::size_t i=begin; i<end; ++i)
+            {
+                _task(_context, i);
+            }
+        }
+    }
+}
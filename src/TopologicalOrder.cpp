@@ -0,0 +1,372 @@
+#include "config/config.h"
+
+#include "TopologicalOrder.h"
+#include "Boundary.h"
+#include "Delay.h"
+#include "core/Graph.h"
+#include "core/GraphNode.h"
+#include "core/Node.h"
+#include "core/Port.h"
+
+#include <algorithm>
+#include <unordered_set>
+
+namespace dag
+{
+    void TopologicalOrder::rebuild(dagbase::Graph& graph)
+    {
+        _order.clear();
+        _rank.clear();
+        _boundaryOf.clear();
+        _numHoles = 0;
+        _valid = false;
+        ++_numRebuilds;
+
+        // The same rule as addEdge(), so that a loop through a Delay is accepted either way.
+        NodeArray nodes;
+        collect(graph, nodes);
+        dagbase::NodeArray sorted;
+        if (!sortWithFeedback(nodes, sorted))
+        {
+            return;
+        }
+
+        _order.reserve(sorted.size());
+        for (auto node : sorted)
+        {
+            _rank.emplace(node, _order.size());
+            _order.emplace_back(node);
+        }
+        _valid = true;
+    }
+
+    void TopologicalOrder::collect(dagbase::Graph& graph, NodeArray& nodes)
+    {
+        graph.eachNode([this, &nodes](dagbase::Node* node)
+        {
+            nodes.emplace_back(node);
+            if (auto boundary = dynamic_cast<Boundary*>(node))
+            {
+                for (std::size_t portIndex=0; portIndex<boundary->totalPorts(); ++portIndex)
+                {
+                    if (auto port = boundary->dynamicPort(portIndex))
+                    {
+                        _boundaryOf.emplace(port, boundary);
+                    }
+                }
+            }
+            else if (auto graphNode = dynamic_cast<dagbase::GraphNode*>(node); graphNode != nullptr && graphNode->graph() != nullptr)
+            {
+                collect(*graphNode->graph(), nodes);
+            }
+
+            return true;
+        });
+    }
+
+    dagbase::Node* TopologicalOrder::owner(const dagbase::Port* port) const
+    {
+        auto it = _boundaryOf.find(port);
+
+        return it != _boundaryOf.end() ? it->second : port->parent();
+    }
+
+    bool TopologicalOrder::sortWithFeedback(const NodeArray& nodes, dagbase::NodeArray& sorted) const
+    {
+        std::unordered_map<const dagbase::Node*, std::size_t> numProducers;
+        NodeArray unique;
+        NodeArray ready;
+
+        sorted.clear();
+        for (auto node : nodes)
+        {
+            if (numProducers.emplace(node, 0).second)
+            {
+                unique.emplace_back(node);
+            }
+        }
+        for (auto node : unique)
+        {
+            std::size_t count = 0;
+
+            // The Ports of a GraphNode are counted with its Boundaries.
+            if (!Delay::isFeedback(node) && dynamic_cast<const dagbase::GraphNode*>(node) == nullptr)
+            {
+                for (std::size_t portIndex=0; portIndex<node->totalPorts(); ++portIndex)
+                {
+                    auto port = node->dynamicPort(portIndex);
+
+                    if (port == nullptr || port->dir() != dagbase::PortDirection::DIR_IN)
+                    {
+                        continue;
+                    }
+
+                    for (auto connection : port->incomingConnections())
+                    {
+                        count += numProducers.count(owner(connection));
+                    }
+                }
+            }
+            numProducers[node] = count;
+            if (count == 0)
+            {
+                ready.emplace_back(node);
+            }
+        }
+
+        // Kahn's algorithm, with the connections into a Delay left out.
+        while (!ready.empty())
+        {
+            auto node = ready.back();
+            ready.pop_back();
+            sorted.emplace_back(node);
+            if (dynamic_cast<const dagbase::GraphNode*>(node) != nullptr)
+            {
+                continue;
+            }
+
+            for (std::size_t portIndex=0; portIndex<node->totalPorts(); ++portIndex)
+            {
+                auto port = node->dynamicPort(portIndex);
+
+                if (port == nullptr || port->dir() != dagbase::PortDirection::DIR_OUT)
+                {
+                    continue;
+                }
+
+                for (auto connection : port->outgoingConnections())
+                {
+                    auto next = owner(connection);
+
+                    if (Delay::isFeedback(next))
+                    {
+                        continue;
+                    }
+
+                    auto it = numProducers.find(next);
+                    if (it != numProducers.end() && --it->second == 0)
+                    {
+                        ready.emplace_back(next);
+                    }
+                }
+            }
+        }
+
+        return sorted.size() == numProducers.size();
+    }
+
+    void TopologicalOrder::addNode(dagbase::Node* node)
+    {
+        if (!_valid)
+        {
+            return;
+        }
+
+        // The Nodes of a child Graph would have to be sorted in.
+        if (auto graphNode = dynamic_cast<dagbase::GraphNode*>(node); graphNode != nullptr && graphNode->graph() != nullptr && graphNode->graph()->numNodes() != 0)
+        {
+            _valid = false;
+
+            return;
+        }
+
+        if (_rank.emplace(node, _order.size()).second)
+        {
+            _order.emplace_back(node);
+        }
+    }
+
+    void TopologicalOrder::removeNode(const dagbase::Node* node)
+    {
+        auto it = _rank.find(node);
+
+        if (it == _rank.end())
+        {
+            return;
+        }
+
+        _order[it->second] = nullptr;
+        _rank.erase(it);
+        if (++_numHoles > _order.size() / 2)
+        {
+            compact();
+        }
+
+        // A child Graph goes with its GraphNode, and Ports shared through a Boundary change hands.
+        if (dynamic_cast<const dagbase::GraphNode*>(node) != nullptr || dynamic_cast<const Boundary*>(node) != nullptr)
+        {
+            _valid = false;
+        }
+    }
+
+    bool TopologicalOrder::addEdge(const dagbase::Port& fromPort, const dagbase::Port& toPort)
+    {
+        auto from = owner(&fromPort);
+        auto to = owner(&toPort);
+
+        // A feedback edge places no constraint on the order.
+        if (Delay::isFeedback(to))
+        {
+            return true;
+        }
+
+        if (from == to)
+        {
+            return false;
+        }
+
+        auto fromIt = _rank.find(from);
+        auto toIt = _rank.find(to);
+        if (!_valid || fromIt == _rank.end() || toIt == _rank.end())
+        {
+            return true;
+        }
+
+        const auto lower = toIt->second;
+        const auto upper = fromIt->second;
+        if (upper < lower)
+        {
+            return true;
+        }
+
+        // Everything after to that it reaches must move after from, and everything
+        // before from that reaches it must move before to. Nodes outside [lower, upper] are untouched.
+        NodeArray forward;
+        if (!visit(to, lower, upper, true, from, forward))
+        {
+            return false;
+        }
+
+        NodeArray backward;
+        visit(from, lower, upper, false, nullptr, backward);
+
+        auto byRank = [this](const dagbase::Node* a, const dagbase::Node* b)
+        {
+            return _rank[a] < _rank[b];
+        };
+        std::sort(forward.begin(), forward.end(), byRank);
+        std::sort(backward.begin(), backward.end(), byRank);
+
+        std::vector<std::size_t> ranks;
+        ranks.reserve(forward.size() + backward.size());
+        for (auto node : backward)
+        {
+            ranks.emplace_back(_rank[node]);
+        }
+        for (auto node : forward)
+        {
+            ranks.emplace_back(_rank[node]);
+        }
+        std::sort(ranks.begin(), ranks.end());
+
+        std::size_t next = 0;
+        for (auto node : backward)
+        {
+            _order[ranks[next]] = node;
+            _rank[node] = ranks[next++];
+        }
+        for (auto node : forward)
+        {
+            _order[ranks[next]] = node;
+            _rank[node] = ranks[next++];
+        }
+        _numReordered += std::uint32_t(ranks.size());
+
+        return true;
+    }
+
+    bool TopologicalOrder::visit(dagbase::Node* start, std::size_t lower, std::size_t upper, bool forward, const dagbase::Node* stop, NodeArray& visited)
+    {
+        std::unordered_set<const dagbase::Node*> seen;
+
+        _stack.clear();
+        _stack.emplace_back(start);
+        seen.insert(start);
+        while (!_stack.empty())
+        {
+            auto node = _stack.back();
+            _stack.pop_back();
+            visited.emplace_back(node);
+            if (!forward && Delay::isFeedback(node))
+            {
+                continue;
+            }
+
+            for (std::size_t portIndex=0; portIndex<node->totalPorts(); ++portIndex)
+            {
+                auto port = node->dynamicPort(portIndex);
+
+                if (port == nullptr || port->dir() != (forward ? dagbase::PortDirection::DIR_OUT : dagbase::PortDirection::DIR_IN))
+                {
+                    continue;
+                }
+
+                for (auto connection : (forward ? port->outgoingConnections() : port->incomingConnections()))
+                {
+                    auto next = owner(connection);
+
+                    if (forward && Delay::isFeedback(next))
+                    {
+                        continue;
+                    }
+
+                    if (next == stop)
+                    {
+                        return false;
+                    }
+
+                    auto it = _rank.find(next);
+                    if (it == _rank.end() || it->second < lower || it->second > upper || !seen.insert(next).second)
+                    {
+                        continue;
+                    }
+
+                    _stack.emplace_back(next);
+                }
+            }
+        }
+
+        return true;
+    }
+
+    void TopologicalOrder::compact()
+    {
+        _order.erase(std::remove(_order.begin(), _order.end(), nullptr), _order.end());
+        for (std::size_t i=0; i<_order.size(); ++i)
+        {
+            _rank[_order[i]] = i;
+        }
+        _numHoles = 0;
+    }
+
+    void TopologicalOrder::sorted(dagbase::NodeArray* nodes) const
+    {
+        nodes->reserve(nodes->size() + _rank.size());
+        for (auto node : _order)
+        {
+            if (node != nullptr)
+            {
+                nodes->emplace_back(node);
+            }
+        }
+    }
+
+    dagbase::Variant TopologicalOrder::find(std::string_view path) const
+    {
+        dagbase::Variant retval;
+
+        retval = dagbase::findEndpoint(path, "numNodes", std::uint32_t(_rank.size()));
+        if (retval.has_value())
+            return retval;
+
+        retval = dagbase::findEndpoint(path, "numRebuilds", _numRebuilds);
+        if (retval.has_value())
+            return retval;
+
+        retval = dagbase::findEndpoint(path, "numReordered", _numReordered);
+        if (retval.has_value())
+            return retval;
+
+        return {};
+    }
+}
@@ -8,6 +8,8 @@
 
 #include "core/TypedPort.h"
 #include "SelectionLive.h"
+#include "NodeEditorLive.h"
+#include "FastMath.h"
 #include "core/Graph.h"
 
 #include <benchmark/benchmark.h>
@@ -456,6 +458,23 @@ static void BM_TypedPortTransfer(benchmark::State& state)
 
 BENCHMARK(BM_TypedPortTransfer);
 
+static void BM_PortTransfer(benchmark::State& state)
+{
+    // Arg 0 copies double to double, arg 1 converts int64 to double.
+    dagbase::TypedPort<double> doubleOut(dagbase::PortID(1), nullptr, "doubleOut", dagbase::PortType::TYPE_DOUBLE, dagbase::PortDirection::DIR_OUT, 1.0);
+    dagbase::TypedPort<std::int64_t> int64Out(dagbase::PortID(2), nullptr, "int64Out", dagbase::PortType::TYPE_INT64, dagbase::PortDirection::DIR_OUT, 1);
+    dagbase::TypedPort<double> doubleIn(dagbase::PortID(3), nullptr, "doubleIn", dagbase::PortType::TYPE_DOUBLE, dagbase::PortDirection::DIR_IN, 0.0);
+    dagbase::Port* source = state.range(0) != 0 ? static_cast<dagbase::Port*>(&int64Out) : &doubleOut;
+    dag::PortTransfer sut{source, &doubleIn, dag::PortTransfer::selectCopy(*source, doubleIn), dag::PortTransfer::selectEqual(*source, doubleIn)};
+
+    for (auto _ : state)
+    {
+        sut.makeItSo();
+    }
+}
+
+BENCHMARK(BM_PortTransfer)->Arg(0)->Arg(1);
+
 class FooSource
 {
 public:
@@ -546,6 +565,76 @@ static void BM_VirtualMetaPortArray(benchmark::State& state)
 
 BENCHMARK(BM_VirtualMetaPortArray);
 
+static void BM_PortTable(benchmark::State& state)
+{
+    dag::MemoryNodeLibrary nodeLib;
+    auto g = new dagbase::Graph();
+    g->setNodeLibrary(&nodeLib);
+    auto sut = dynamic_cast<dag::Final*>(g->createNode("Final", "final1"));
+
+    for (auto _ : state)
+    {
+        auto port = static_cast<dagbase::TypedPort<double>*>(dag::Final::portTable.port(*sut, 0));
+
+        port->setValue(2.0);
+    }
+    delete g;
+}
+
+BENCHMARK(BM_PortTable);
+
+static void BM_MetaPortTable(benchmark::State& state)
+{
+    std::int64_t i = 0;
+
+    for (auto _ : state)
+    {
+        auto descriptor = dag::Final::portTable.metaPort(1);
+
+        i += descriptor->isOwned();
+    }
+    benchmark::DoNotOptimize(i);
+}
+
+BENCHMARK(BM_MetaPortTable);
+
+static const char* nodeClasses[] = {"FooTyped", "GroupTyped", "MathsNode"};
+
+static void BM_CreateNode(benchmark::State& state)
+{
+    dag::MemoryNodeLibrary nodeLib;
+    const char* className = nodeClasses[state.range(0)];
+
+    for (auto _ : state)
+    {
+        auto node = nodeLib.instantiateNode(nodeLib, className, "node1");
+        benchmark::DoNotOptimize(node);
+        delete node;
+    }
+    state.SetLabel(className);
+}
+
+BENCHMARK(BM_CreateNode)->DenseRange(0, 2);
+
+static void BM_CloneNode(benchmark::State& state)
+{
+    dag::MemoryNodeLibrary nodeLib;
+    const char* className = nodeClasses[state.range(0)];
+    auto node = nodeLib.instantiateNode(nodeLib, className, "node1");
+
+    for (auto _ : state)
+    {
+        dagbase::CloningFacility facility;
+        auto clone = node->clone(facility, dagbase::CopyOp{0}, nullptr);
+        benchmark::DoNotOptimize(clone);
+        delete clone;
+    }
+    state.SetLabel(className);
+    delete node;
+}
+
+BENCHMARK(BM_CloneNode)->DenseRange(0, 2);
+
 static void BM_SelectionLiveAdd(benchmark::State& state)
 {
     dag::MemoryNodeLibrary nodeLib;
@@ -666,4 +755,558 @@ static void BM_StaticCastPort(benchmark::State& state)
 
 BENCHMARK(BM_StaticCastPort);
 
+//! Build a chain of GroupTyped Nodes, each feeding the next.
+static void buildChain(dag::NodeEditorLive& editor, std::size_t length)
+{
+    dagbase::Port* previous = nullptr;
+
+    for (std::size_t i=0; i<length; ++i)
+    {
+        auto status = editor.createNode("GroupTyped", "group" + std::to_string(i));
+        auto node = editor.rootGraph()->node(dagbase::NodeID(status.result));
+
+        if (previous != nullptr)
+        {
+            editor.connect(previous->id(), node->dynamicPort(1)->id());
+        }
+        previous = node->dynamicPort(0);
+    }
+}
+
+static void BM_EvaluateSortEveryFrame(benchmark::State& state)
+{
+    dag::NodeEditorLive editor;
+    buildChain(editor, std::size_t(state.range(0)));
+    auto graph = editor.rootGraph();
+
+    for (auto _ : state)
+    {
+        dagbase::NodeArray order;
+        graph->topologicalSort(&order);
+        graph->evaluate(order);
+    }
+}
+
+BENCHMARK(BM_EvaluateSortEveryFrame)->RangeMultiplier(16)->Range(16, 4096);
+
+static void BM_EvaluatePlan(benchmark::State& state)
+{
+    dag::NodeEditorLive editor;
+    buildChain(editor, std::size_t(state.range(0)));
+
+    for (auto _ : state)
+    {
+        editor.evaluate();
+    }
+}
+
+BENCHMARK(BM_EvaluatePlan)->RangeMultiplier(16)->Range(16, 4096);
+
+static void buildLayers(dag::NodeEditorLive& editor, std::size_t width, std::size_t depth)
+{
+    std::vector<dagbase::Port*> previous(width, nullptr);
+
+    for (std::size_t layer=0; layer<depth; ++layer)
+    {
+        for (std::size_t i=0; i<width; ++i)
+        {
+            auto status = editor.createNode("MathsNode", "maths" + std::to_string(layer) + "_" + std::to_string(i));
+            auto node = editor.rootGraph()->node(dagbase::NodeID(status.result));
+
+            if (previous[i] != nullptr)
+            {
+                editor.connect(previous[i]->id(), node->dynamicPort(0)->id());
+            }
+            else
+            {
+                static_cast<dagbase::TypedPort<double>*>(node->dynamicPort(0))->setValue(0.001 * double(i));
+            }
+            previous[i] = node->dynamicPort(2);
+        }
+    }
+}
+
+static void BM_EvaluateLevelParallel(benchmark::State& state)
+{
+    dag::NodeEditorLive editor;
+    buildLayers(editor, 512, 8);
+    editor.setNumThreads(std::size_t(state.range(0)));
+
+    for (auto _ : state)
+    {
+        editor.evaluate();
+    }
+}
+
+BENCHMARK(BM_EvaluateLevelParallel)->RangeMultiplier(2)->Range(1, 16)->UseRealTime();
+
+static void BM_EvaluateDataflow(benchmark::State& state)
+{
+    dag::NodeEditorLive editor;
+    buildLayers(editor, 512, 8);
+    editor.setNumThreads(std::size_t(state.range(0)));
+    editor.setScheduler(dag::EvaluationPlan::SCHEDULER_DATAFLOW);
+
+    for (auto _ : state)
+    {
+        editor.evaluate();
+    }
+}
+
+BENCHMARK(BM_EvaluateDataflow)->RangeMultiplier(2)->Range(1, 16)->UseRealTime();
+
+static void BM_EvaluateDirtyOneSource(benchmark::State& state)
+{
+    dag::NodeEditorLive editor;
+    buildLayers(editor, std::size_t(state.range(0)), 8);
+    editor.evaluateDirty();
+    auto source = editor.rootGraph()->node(dagbase::NodeID(0))->dynamicPort(0)->id();
+    double angle = 0.0;
+
+    for (auto _ : state)
+    {
+        angle += 0.001;
+        editor.setValue(source, dagbase::Value(angle));
+        editor.evaluateDirty();
+    }
+}
+
+BENCHMARK(BM_EvaluateDirtyOneSource)->RangeMultiplier(8)->Range(8, 4096);
+
+static void BM_EvaluateAllOneSource(benchmark::State& state)
+{
+    dag::NodeEditorLive editor;
+    buildLayers(editor, std::size_t(state.range(0)), 8);
+    auto source = editor.rootGraph()->node(dagbase::NodeID(0))->dynamicPort(0)->id();
+    double angle = 0.0;
+
+    for (auto _ : state)
+    {
+        angle += 0.001;
+        editor.setValue(source, dagbase::Value(angle));
+        editor.evaluate();
+    }
+}
+
+BENCHMARK(BM_EvaluateAllOneSource)->RangeMultiplier(8)->Range(8, 4096);
+
+static void BM_EvaluateForOneProbe(benchmark::State& state)
+{
+    dag::NodeEditorLive editor;
+    buildLayers(editor, std::size_t(state.range(0)), 8);
+    // The last Node of the first column depends on one Node per layer.
+    auto probe = editor.rootGraph()->node(dagbase::NodeID(7 * state.range(0)))->dynamicPort(2)->id();
+
+    for (auto _ : state)
+    {
+        editor.evaluateFor(probe);
+    }
+}
+
+BENCHMARK(BM_EvaluateForOneProbe)->RangeMultiplier(8)->Range(8, 4096);
+
+static void BM_EvaluateBatch(benchmark::State& state)
+{
+    const auto batchSize = std::size_t(state.range(0));
+    dag::NodeEditorLive editor;
+    buildLayers(editor, 64, 8);
+    editor.prepareBatch(batchSize);
+
+    for (auto _ : state)
+    {
+        editor.evaluateBatch();
+    }
+    state.SetItemsProcessed(std::int64_t(state.iterations()) * std::int64_t(batchSize));
+}
+
+BENCHMARK(BM_EvaluateBatch)->RangeMultiplier(4)->Range(1, 4096);
+
+static void BM_EvaluateBatchZeroCopy(benchmark::State& state)
+{
+    dag::NodeEditorLive editor;
+    buildLayers(editor, 64, 8);
+    // Compare copying each sample array along a connection with sharing the array of the output.
+    editor.setZeroCopy(state.range(1) != 0);
+    editor.prepareBatch(std::size_t(state.range(0)));
+
+    for (auto _ : state)
+    {
+        editor.evaluateBatch();
+    }
+}
+
+BENCHMARK(BM_EvaluateBatchZeroCopy)->ArgsProduct({{64, 1024, 4096}, {0, 1}});
+
+static void BM_EvaluateSamplesOneAtATime(benchmark::State& state)
+{
+    const auto batchSize = std::size_t(state.range(0));
+    dag::NodeEditorLive editor;
+    buildLayers(editor, 64, 8);
+
+    for (auto _ : state)
+    {
+        for (std::size_t sample=0; sample<batchSize; ++sample)
+        {
+            editor.evaluate();
+        }
+    }
+    state.SetItemsProcessed(std::int64_t(state.iterations()) * std::int64_t(batchSize));
+}
+
+BENCHMARK(BM_EvaluateSamplesOneAtATime)->RangeMultiplier(4)->Range(1, 4096);
+
+// A chain of MathsNodes in which every Node is wrapped in its own child Graph.
+static void buildWrappedChain(dag::NodeEditorLive& editor, std::size_t length)
+{
+    std::vector<dagbase::Node*> nodes;
+    dagbase::Port* previous = nullptr;
+
+    for (std::size_t i=0; i<length; ++i)
+    {
+        auto status = editor.createNode("MathsNode", "maths" + std::to_string(i));
+        auto node = editor.rootGraph()->node(dagbase::NodeID(status.result));
+
+        if (previous != nullptr)
+        {
+            editor.connect(previous->id(), node->dynamicPort(0)->id());
+        }
+        previous = node->dynamicPort(2);
+        nodes.emplace_back(node);
+    }
+
+    for (auto node : nodes)
+    {
+        dag::SelectionInterface::Cont selection;
+        selection.emplace(node);
+        editor.select(dag::NodeEditorInterface::SELECTION_SET, selection);
+        editor.createChild();
+    }
+}
+
+static void BM_EvaluateWrappedChain(benchmark::State& state)
+{
+    dag::NodeEditorLive editor;
+    buildWrappedChain(editor, std::size_t(state.range(0)));
+    editor.setFlattenBoundaries(state.range(1) != 0);
+
+    for (auto _ : state)
+    {
+        editor.evaluate();
+    }
+}
+
+BENCHMARK(BM_EvaluateWrappedChain)->ArgsProduct({{16, 256, 1024}, {0, 1}});
+
+static void BM_EvaluateFoldedLayers(benchmark::State& state)
+{
+    dag::NodeEditorLive editor;
+    buildLayers(editor, 512, 8);
+    editor.setFoldConstants(state.range(0) != 0);
+
+    for (auto _ : state)
+    {
+        editor.evaluate();
+    }
+}
+
+BENCHMARK(BM_EvaluateFoldedLayers)->Arg(0)->Arg(1);
+
+static void BM_EvaluatePrunedLayers(benchmark::State& state)
+{
+    const std::size_t width = 512;
+    const std::size_t depth = 8;
+    dag::NodeEditorLive editor;
+    buildLayers(editor, width, depth);
+    editor.setPruneDeadNodes(true);
+    // Only the pinned columns are read, the rest of the layers are dead.
+    for (std::size_t i=0; i<std::size_t(state.range(0)); ++i)
+    {
+        auto node = editor.rootGraph()->node(dagbase::NodeID((depth - 1) * width + i));
+        editor.pinPort(node->dynamicPort(2)->id());
+    }
+
+    for (auto _ : state)
+    {
+        editor.evaluate();
+    }
+}
+
+BENCHMARK(BM_EvaluatePrunedLayers)->Arg(1)->Arg(64)->Arg(512);
+
+static void BM_ConnectDisconnect(benchmark::State& state)
+{
+    const std::size_t width = std::size_t(state.range(0));
+    dag::NodeEditorLive editor;
+    buildLayers(editor, width, 8);
+    // The spare Node is last in the order, so connecting it to the first column moves that column.
+    auto spare = editor.rootGraph()->node(dagbase::NodeID(editor.createNode("MathsNode", "spare").result));
+    auto first = editor.rootGraph()->node(dagbase::NodeID(0));
+    auto graph = editor.rootGraph();
+
+    for (auto _ : state)
+    {
+        auto status = editor.connect(spare->dynamicPort(2)->id(), first->dynamicPort(0)->id());
+        // The cost of a full sort after every edit, for comparison.
+        if (state.range(1) != 0)
+        {
+            dagbase::NodeArray order;
+            graph->topologicalSort(&order);
+        }
+        editor.disconnect(dagbase::SignalPathID(status.result));
+    }
+}
+
+BENCHMARK(BM_ConnectDisconnect)->ArgsProduct({{64, 4096, 25000}, {0, 1}});
+
+static void BM_EvaluateProfiled(benchmark::State& state)
+{
+    dag::NodeEditorLive editor;
+    buildLayers(editor, 512, 8);
+    editor.setProfiling(state.range(0) != 0);
+
+    for (auto _ : state)
+    {
+        editor.evaluate();
+    }
+}
+
+BENCHMARK(BM_EvaluateProfiled)->Arg(0)->Arg(1);
+
+static void BM_EvaluateInstances(benchmark::State& state)
+{
+    dag::NodeEditorLive editor;
+    buildLayers(editor, 1, 8);
+    editor.prepareInstances(std::size_t(state.range(0)));
+
+    for (auto _ : state)
+    {
+        editor.evaluateInstances();
+    }
+}
+
+BENCHMARK(BM_EvaluateInstances)->RangeMultiplier(16)->Range(16, 16384);
+
+static void BM_EvaluateClones(benchmark::State& state)
+{
+    // The same chain repeated as separate Nodes, for comparison with BM_EvaluateInstances.
+    dag::NodeEditorLive editor;
+    buildLayers(editor, std::size_t(state.range(0)), 8);
+
+    for (auto _ : state)
+    {
+        editor.evaluate();
+    }
+}
+
+BENCHMARK(BM_EvaluateClones)->RangeMultiplier(16)->Range(16, 16384);
+
+static void BM_EvaluateMemoisedChild(benchmark::State& state)
+{
+    // A long chain wrapped in a child Graph, evaluated with unchanging inputs.
+    dag::NodeEditorLive editor;
+    buildLayers(editor, 1, 256);
+    dag::SelectionInterface::Cont selection;
+    editor.rootGraph()->eachNode([&selection](dagbase::Node* node)
+    {
+        if (node->id() != dagbase::NodeID(0))
+        {
+            selection.emplace(node);
+        }
+
+        return true;
+    });
+    editor.select(dag::NodeEditorInterface::SELECTION_SET, selection);
+    auto status = editor.createChild();
+    if (state.range(0) != 0)
+    {
+        editor.setMemoise(dagbase::NodeID(status.result), 16);
+    }
+
+    for (auto _ : state)
+    {
+        editor.evaluate();
+    }
+}
+
+BENCHMARK(BM_EvaluateMemoisedChild)->Arg(0)->Arg(1);
+
+static void BM_EvaluateGatedLayers(benchmark::State& state)
+{
+    const std::size_t width = 512;
+    dag::NodeEditorLive editor;
+    buildLayers(editor, width, 8);
+    // The condition feeds the first layer, so every layer is downstream of its gate.
+    auto condition = editor.rootGraph()->node(dagbase::NodeID(editor.createNode("Derived", "condition").result));
+    for (std::size_t col=0; col<width; ++col)
+    {
+        auto node = editor.rootGraph()->node(dagbase::NodeID(col));
+        editor.connect(condition->dynamicPort(0)->id(), node->dynamicPort(0)->id());
+    }
+    static_cast<dagbase::TypedPort<bool>*>(condition->dynamicPort(1))->setValue(state.range(0) != 0);
+
+    for (auto _ : state)
+    {
+        editor.evaluate();
+    }
+}
+
+BENCHMARK(BM_EvaluateGatedLayers)->Arg(0)->Arg(1);
+
+// One long chain beside many short columns, created first so that it is dealt to a worker
+// before the columns it competes with.
+static void buildSkewed(dag::NodeEditorLive& editor, std::size_t chainLength, std::size_t width, std::size_t depth)
+{
+    dagbase::Port* previous = nullptr;
+
+    for (std::size_t i=0; i<chainLength; ++i)
+    {
+        auto node = editor.rootGraph()->node(dagbase::NodeID(editor.createNode("MathsNode", "chain" + std::to_string(i)).result));
+
+        if (previous != nullptr)
+        {
+            editor.connect(previous->id(), node->dynamicPort(0)->id());
+        }
+        previous = node->dynamicPort(2);
+    }
+    buildLayers(editor, width, depth);
+}
+
+static void BM_EvaluateSkewed(benchmark::State& state)
+{
+    dag::NodeEditorLive editor;
+    buildSkewed(editor, 256, 1024, 2);
+    editor.setNumThreads(4);
+    // Plain topological order, last in first out, against the longest remaining path first.
+    editor.setScheduler(state.range(0) != 0 ? dag::EvaluationPlan::SCHEDULER_CRITICAL_PATH : dag::EvaluationPlan::SCHEDULER_DATAFLOW);
+    // Weigh the paths by the profiled cost of each Node.
+    editor.setProfiling(true);
+    editor.evaluate();
+    editor.setProfiling(false);
+
+    for (auto _ : state)
+    {
+        editor.evaluate();
+    }
+}
+
+BENCHMARK(BM_EvaluateSkewed)->Arg(0)->Arg(1)->UseRealTime();
+
+static void BM_EvaluateMultiRate(benchmark::State& state)
+{
+    const std::size_t width = 512;
+    const std::size_t depth = 8;
+    dag::NodeEditorLive editor;
+    buildLayers(editor, width, depth);
+    // The given percentage of columns run at a tenth of the rate of the rest.
+    const std::size_t numSlow = width * std::size_t(state.range(0)) / 100;
+    for (std::size_t layer=0; layer<depth; ++layer)
+    {
+        for (std::size_t col=0; col<numSlow; ++col)
+        {
+            editor.setDivisor(dagbase::NodeID(layer * width + col), 10);
+        }
+    }
+
+    for (auto _ : state)
+    {
+        editor.evaluate();
+    }
+}
+
+BENCHMARK(BM_EvaluateMultiRate)->Arg(0)->Arg(50)->Arg(90)->Arg(100);
+
+static void BM_EvaluateRecurrent(benchmark::State& state)
+{
+    const std::size_t width = std::size_t(state.range(0));
+    dag::NodeEditorLive editor;
+    buildLayers(editor, width, 8);
+    // Feed the last layer of each column back into its first through a Delay.
+    for (std::size_t col=0; col<width; ++col)
+    {
+        auto delay = editor.rootGraph()->node(dagbase::NodeID(editor.createNode("Delay", "delay" + std::to_string(col)).result));
+        auto first = editor.rootGraph()->node(dagbase::NodeID(col));
+        auto last = editor.rootGraph()->node(dagbase::NodeID(7 * width + col));
+        editor.connect(delay->dynamicPort(1)->id(), first->dynamicPort(0)->id());
+        editor.connect(last->dynamicPort(2)->id(), delay->dynamicPort(0)->id());
+    }
+
+    for (auto _ : state)
+    {
+        editor.evaluate();
+    }
+}
+
+BENCHMARK(BM_EvaluateRecurrent)->RangeMultiplier(8)->Range(8, 512);
+
+static void BM_EvaluateFusedLayers(benchmark::State& state)
+{
+    dag::NodeEditorLive editor;
+    buildLayers(editor, 64, std::size_t(state.range(0)));
+    editor.setFuseChains(state.range(1) != 0);
+
+    for (auto _ : state)
+    {
+        editor.evaluate();
+    }
+}
+
+BENCHMARK(BM_EvaluateFusedLayers)->ArgsProduct({{8, 64}, {0, 1}});
+
+static void BM_SinStd(benchmark::State& state)
+{
+    std::vector<double> x(std::size_t(state.range(0)));
+    std::vector<double> y(x.size());
+    for (std::size_t i=0; i<x.size(); ++i)
+    {
+        x[i] = 0.001 * double(i);
+    }
+
+    for (auto _ : state)
+    {
+        for (std::size_t i=0; i<x.size(); ++i)
+        {
+            y[i] = std::sin(x[i]);
+        }
+        benchmark::DoNotOptimize(y.data());
+    }
+    state.SetItemsProcessed(std::int64_t(state.iterations()) * state.range(0));
+}
+
+BENCHMARK(BM_SinStd)->Arg(4096);
+
+static void BM_SinFastMath(benchmark::State& state)
+{
+    std::vector<double> x(std::size_t(state.range(0)));
+    std::vector<double> y(x.size());
+    for (std::size_t i=0; i<x.size(); ++i)
+    {
+        x[i] = 0.001 * double(i);
+    }
+    const auto accuracy = dag::FastMath::Accuracy(state.range(1));
+
+    for (auto _ : state)
+    {
+        dag::FastMath::sin(x.data(), y.data(), x.size(), 1.0, accuracy);
+        benchmark::DoNotOptimize(y.data());
+    }
+    state.SetItemsProcessed(std::int64_t(state.iterations()) * state.range(0));
+}
+
+BENCHMARK(BM_SinFastMath)->ArgsProduct({{4096}, {dag::FastMath::ACCURACY_EXACT, dag::FastMath::ACCURACY_ULP, dag::FastMath::ACCURACY_FAST}});
+
+static void BM_EvaluateWithin(benchmark::State& state)
+{
+    dag::NodeEditorLive editor;
+    buildLayers(editor, 512, 8);
+    const std::chrono::microseconds budget(state.range(0));
+    bool finished = false;
+
+    for (auto _ : state)
+    {
+        editor.evaluateWithin(budget, finished);
+    }
+}
+
+BENCHMARK(BM_EvaluateWithin)->Arg(10)->Arg(100)->Arg(1000);
+
 BENCHMARK_MAIN();
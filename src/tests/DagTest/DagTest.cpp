@@ -10,7 +10,12 @@
 #include "core/Graph.h"
 #include "SelectionLive.h"
 #include "NodeEditorLive.h"
+#include "EvaluationProfile.h"
+#include "FastMath.h"
+#include "MathNode.h"
+#include "Delay.h"
 #include "Boundary.h"
+#include "PrimitivePort.h"
 #include "core/SignalPath.h"
 #include "CreateNode.h"
 #include "core/ByteBuffer.h"
@@ -30,7 +35,9 @@
 
 #include <iostream>
 #include <algorithm>
+#include <cmath>
 #include <filesystem>
+#include <sstream>
 
 class MemoryNodeLibraryTest : public ::testing::TestWithParam<std::tuple<const char*, const char*, size_t, const char*, dagbase::PortDirection::Direction, double>>
 {
@@ -144,7 +151,43 @@ INSTANTIATE_TEST_SUITE_P(NodeTestClone, NodeTest_testClone, ::testing::Values(
     std::make_tuple("GroupTyped", "group1"),
     std::make_tuple("MathsNode", "m1"),
     std::make_tuple("FooTyped", "foo1"),
-    std::make_tuple("BarTyped", "bar1")
+    std::make_tuple("BarTyped", "bar1"),
+    std::make_tuple("Delay", "delay1")
+));
+
+class NodeTest_testInlinePorts : public ::testing::TestWithParam<std::tuple<const char*, std::size_t>>
+{
+};
+
+TEST_P(NodeTest_testInlinePorts, testPortsLieInsideTheNode)
+{
+    const char* className = std::get<0>(GetParam());
+    const std::size_t nodeSize = std::get<1>(GetParam());
+    dag::MemoryNodeLibrary nodeLib;
+    dagbase::Node* node = nodeLib.instantiateNode(nodeLib, className, "node1");
+    ASSERT_NE(nullptr, node);
+    dagbase::CloningFacility facility;
+    dagbase::Node* clone = node->clone(facility, dagbase::CopyOp{0}, nullptr);
+    ASSERT_TRUE(node->equals(*clone, dagbase::CMP_NONE));
+    for (auto sut : {node, clone})
+    {
+        const auto begin = reinterpret_cast<std::uintptr_t>(sut);
+        for (std::size_t i=0; i<sut->totalPorts(); ++i)
+        {
+            const auto port = reinterpret_cast<std::uintptr_t>(sut->dynamicPort(i));
+            EXPECT_TRUE(port >= begin && port < begin + nodeSize) << className << ':' << i;
+        }
+    }
+    delete clone;
+    delete node;
+}
+
+INSTANTIATE_TEST_SUITE_P(NodeTest, NodeTest_testInlinePorts, ::testing::Values(
+    std::make_tuple("FooTyped", sizeof(dag::FooTyped)),
+    std::make_tuple("BarTyped", sizeof(dag::BarTyped)),
+    std::make_tuple("GroupTyped", sizeof(dag::GroupTyped)),
+    std::make_tuple("MathsNode", sizeof(dag::MathsNode)),
+    std::make_tuple("Delay", sizeof(dag::Delay))
 ));
 
 TEST(TypedTransferTest, checkMakeItSo)
@@ -503,6 +546,80 @@ TEST(NodeTest, testDynamicsPortDescriptorsForFinal)
     delete sut;
 }
 
+TEST(NodeTest, testPortTableMatchesDynamicPorts)
+{
+    dag::MemoryNodeLibrary nodeLib;
+    auto const sut = dynamic_cast<dag::Final*>(nodeLib.instantiateNode(nodeLib, "Final", "final1"));
+    ASSERT_NE(nullptr, sut);
+    sut->addDynamicPort(new dagbase::TypedPort<double>(dagbase::PortID(0), "output1", dagbase::PortType::TYPE_DOUBLE, dagbase::PortDirection::DIR_OUT, 1.0), dagbase::MetaPort::FLAGS_OWN_BIT);
+    const auto& table = dag::Final::portTable;
+    ASSERT_EQ(size_t{3}, table.size());
+    for (std::size_t i=0; i<table.size(); ++i)
+    {
+        EXPECT_EQ(sut->dynamicPort(i), table.port(*sut, i));
+        EXPECT_EQ(sut->dynamicMetaPort(i), table.metaPort(i));
+    }
+    // The table of Derived is the start of that of Final.
+    for (std::size_t i=0; i<dag::Derived::portTable.size(); ++i)
+    {
+        EXPECT_EQ(dag::Derived::portTable.port(*sut, i), table.port(*sut, i));
+    }
+    // Dynamic Ports are past the end of the table.
+    EXPECT_EQ(nullptr, table.port(*sut, 3));
+    EXPECT_EQ("output1", sut->dynamicPort(3)->name());
+    EXPECT_EQ("trigger", table.port(*sut, 1)->name());
+    delete sut;
+}
+
+TEST(NodeTest, testPortTableAfterReadFromStream)
+{
+    dagbase::Lua lua;
+    dag::MemoryNodeLibrary nodeLib;
+    auto const source = dynamic_cast<dag::Final*>(nodeLib.instantiateNode(nodeLib, "Final", "final1"));
+    ASSERT_NE(nullptr, source);
+    auto const sut = dynamic_cast<dag::Final*>(nodeLib.instantiateNode(nodeLib, "Final", "final2"));
+    ASSERT_NE(nullptr, sut);
+    dagbase::MemoryBackingStore store;
+    store.open(dagbase::BackingStore::MODE_OUTPUT_BIT, "");
+    dagbase::BinaryOutputStream ostr(&store);
+    source->Derived::writeToStream(ostr, nodeLib, lua);
+    ostr.flush();
+    store.open(dagbase::BackingStore::MODE_INPUT_BIT, "");
+    dagbase::BinaryInputStream istr(&store);
+    // Replaces the Ports of Base and Derived, but not int1.
+    sut->readFromStream(istr, nodeLib, lua);
+    const auto& table = dag::Final::portTable;
+    for (std::size_t i=0; i<table.size(); ++i)
+    {
+        ASSERT_NE(nullptr, table.port(*sut, i));
+        EXPECT_EQ(sut->dynamicPort(i), table.port(*sut, i));
+        EXPECT_EQ(table.port(*source, i)->name(), table.port(*sut, i)->name());
+    }
+    EXPECT_EQ(source->dynamicPort(0)->id(), table.port(*sut, 0)->id());
+    EXPECT_EQ(source->dynamicPort(1)->id(), table.port(*sut, 1)->id());
+    EXPECT_NE(source->dynamicPort(2)->id(), table.port(*sut, 2)->id());
+
+    // A Final read back whole agrees with its table too.
+    dagbase::MemoryBackingStore finalStore;
+    finalStore.open(dagbase::BackingStore::MODE_OUTPUT_BIT, "");
+    dagbase::BinaryOutputStream finalOut(&finalStore);
+    sut->writeToStream(finalOut, nodeLib, lua);
+    finalOut.flush();
+    finalStore.open(dagbase::BackingStore::MODE_INPUT_BIT, "");
+    dagbase::BinaryInputStream finalIn(&finalStore);
+    auto const actual = new dag::Final(finalIn, nodeLib, lua);
+    ASSERT_EQ(table.size(), actual->totalPorts());
+    for (std::size_t i=0; i<table.size(); ++i)
+    {
+        ASSERT_NE(nullptr, table.port(*actual, i));
+        EXPECT_EQ(actual->dynamicPort(i), table.port(*actual, i));
+        EXPECT_EQ(sut->dynamicPort(i)->id(), table.port(*actual, i)->id());
+    }
+    delete actual;
+    delete sut;
+    delete source;
+}
+
 class NodeTestDynamicPortsForNode : public ::testing::TestWithParam<std::tuple<const char*, size_t, const char*>>
 {
 	
@@ -1035,6 +1152,10 @@ struct NodeEditorLiveScriptItem
         COMMAND_LOAD,
         COMMAND_SERIALISE,
         COMMAND_DESERIALISE,
+        COMMAND_EVALUATE,
+        COMMAND_EVALUATE_DIRTY,
+        COMMAND_SET_VALUE,
+        COMMAND_EVALUATE_FOR,
     };
 
     void configure(dagbase::ConfigurationElement& config)
@@ -1147,6 +1268,22 @@ struct NodeEditorLiveScriptItem
             dagbase::ConfigurationElement::readConfig(config, "status", &status);
             dagbase::ConfigurationElement::readConfig(config, "filename", &filename);
 
+            break;
+        case COMMAND_EVALUATE:
+        case COMMAND_EVALUATE_DIRTY:
+            dagbase::ConfigurationElement::readConfig(config, "status", &status);
+
+            break;
+        case COMMAND_SET_VALUE:
+            dagbase::ConfigurationElement::readConfig(config, "status", &status);
+            dagbase::ConfigurationElement::readConfig(config, "port", &fromPort);
+            dagbase::ConfigurationElement::readConfig(config, "value", &portValue);
+
+            break;
+        case COMMAND_EVALUATE_FOR:
+            dagbase::ConfigurationElement::readConfig(config, "status", &status);
+            dagbase::ConfigurationElement::readConfig(config, "port", &fromPort);
+
             break;
         default:
             FAIL() << "Creating unknown command";
@@ -1300,6 +1437,26 @@ struct NodeEditorLiveScriptItem
             actualStatus = sut.deserialise(*istr, lua);
             break;
         }
+        case COMMAND_EVALUATE:
+        {
+            actualStatus = sut.evaluate();
+            break;
+        }
+        case COMMAND_EVALUATE_DIRTY:
+        {
+            actualStatus = sut.evaluateDirty();
+            break;
+        }
+        case COMMAND_SET_VALUE:
+        {
+            actualStatus = sut.setValue(fromPort, dagbase::Value(portValue));
+            break;
+        }
+        case COMMAND_EVALUATE_FOR:
+        {
+            actualStatus = sut.evaluateFor(fromPort);
+            break;
+        }
         default:
             done = true;
             FAIL() << "Got into an unhandled command " << commandToString(cmd);
@@ -1334,6 +1491,7 @@ struct NodeEditorLiveScriptItem
     dag::NodeEditorLive::GraphChildPath graphChildPath;
     std::string filename;
     float position[2];
+    double portValue{0.0};
     dagbase::ComparisonFlags cmpFlags{dagbase::CMP_NONE};
     bool done{ false };
 
@@ -1400,6 +1558,10 @@ struct NodeEditorLiveScriptItem
             ENUM_NAME(COMMAND_LOAD)
             ENUM_NAME(COMMAND_SERIALISE)
             ENUM_NAME(COMMAND_DESERIALISE)
+            ENUM_NAME(COMMAND_EVALUATE)
+            ENUM_NAME(COMMAND_EVALUATE_DIRTY)
+            ENUM_NAME(COMMAND_SET_VALUE)
+            ENUM_NAME(COMMAND_EVALUATE_FOR)
         }
 
         return "<error>";
@@ -1426,6 +1588,10 @@ struct NodeEditorLiveScriptItem
         TEST_ENUM(COMMAND_LOAD, str);
         TEST_ENUM(COMMAND_SERIALISE, str);
         TEST_ENUM(COMMAND_DESERIALISE, str);
+        TEST_ENUM(COMMAND_EVALUATE, str);
+        TEST_ENUM(COMMAND_EVALUATE_DIRTY, str);
+        TEST_ENUM(COMMAND_SET_VALUE, str);
+        TEST_ENUM(COMMAND_EVALUATE_FOR, str);
 
         return COMMAND_UNKNOWN;
     }
@@ -1567,6 +1733,7 @@ INSTANTIATE_TEST_SUITE_P(NodeEditorLive, NodeEditorLive_testScripted, ::testing:
     std::make_tuple("etc/tests/NodeEditorLive/ConnectThenDisconnect.lua"),
     std::make_tuple("etc/tests/NodeEditorLive/ConnectToIncompatible.lua"),
     std::make_tuple("etc/tests/NodeEditorLive/ConnectToSelf.lua"),
+    std::make_tuple("etc/tests/NodeEditorLive/ConnectCycle.lua"),
     std::make_tuple("etc/tests/NodeEditorLive/ConnectSwappedPorts.lua"),
     std::make_tuple("etc/tests/NodeEditorLive/ConnectInvalidFrom.lua"),
     std::make_tuple("etc/tests/NodeEditorLive/ConnectInvalidTo.lua"),
@@ -1586,7 +1753,11 @@ INSTANTIATE_TEST_SUITE_P(NodeEditorLive, NodeEditorLive_testScripted, ::testing:
     std::make_tuple("etc/tests/NodeEditorLive/SelectionAll.lua"),
     std::make_tuple("etc/tests/NodeEditorLive/SetActiveGraphInvalidPath.lua"),
     std::make_tuple("etc/tests/NodeEditorLive/DeleteValid.lua"),
-    std::make_tuple("etc/tests/NodeEditorLive/DeleteInvalid.lua")
+    std::make_tuple("etc/tests/NodeEditorLive/DeleteInvalid.lua"),
+    std::make_tuple("etc/tests/NodeEditorLive/EvaluatePlan.lua"),
+    std::make_tuple("etc/tests/NodeEditorLive/EvaluateDirty.lua"),
+    std::make_tuple("etc/tests/NodeEditorLive/EvaluateFor.lua"),
+    std::make_tuple("etc/tests/NodeEditorLive/DeserialiseTwiceThenDelete.lua")
 ));
 
 TEST(BoundaryNode, testAddDynamicPort)
@@ -2225,6 +2396,985 @@ INSTANTIATE_TEST_SUITE_P(Graph, GraphTest_testEvaluate, ::testing::Values(
         std::make_tuple("etc/tests/Graph/constraints.lua", 0, 2, 1.0)
         ));
 
+class NodeEditorLiveTest_testEvaluate : public ::testing::TestWithParam<std::tuple<const char*, dagbase::NodeID, std::size_t, double>>
+{
+};
+
+TEST_P(NodeEditorLiveTest_testEvaluate, testEvaluate)
+{
+    const char* graphFilename = std::get<0>(GetParam());
+    dagbase::NodeID nodeId = std::get<1>(GetParam());
+    std::size_t portIndex = std::get<2>(GetParam());
+    double value = std::get<3>(GetParam());
+
+    dag::NodeEditorLive sut;
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.load(graphFilename).status);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.evaluate().status);
+    // A second frame reuses the plan.
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.evaluate().status);
+    dagbase::Node* actualNode = sut.rootGraph()->node(nodeId);
+    ASSERT_NE(nullptr, actualNode);
+    dagbase::Port* actualPort = actualNode->dynamicPort(portIndex);
+    ASSERT_NE(nullptr, actualPort);
+    dagbase::ValueVisitor visitor;
+    ASSERT_EQ(dagbase::PortType::TYPE_DOUBLE, actualPort->type());
+    actualPort->accept(visitor);
+    EXPECT_EQ(value, visitor.value().operator double());
+}
+
+INSTANTIATE_TEST_SUITE_P(NodeEditorLive, NodeEditorLiveTest_testEvaluate, ::testing::Values(
+        std::make_tuple("etc/tests/Graph/constraints.lua", 0, 2, 1.0)
+        ));
+
+static void buildMathsLayers(dag::NodeEditorLive& editor, std::size_t width, std::size_t depth)
+{
+    std::vector<dagbase::Port*> previous(width, nullptr);
+
+    for (std::size_t layer=0; layer<depth; ++layer)
+    {
+        for (std::size_t i=0; i<width; ++i)
+        {
+            auto status = editor.createNode("MathsNode", "maths" + std::to_string(layer) + "_" + std::to_string(i));
+            ASSERT_EQ(dagbase::Status::STATUS_OK, status.status);
+            auto node = editor.rootGraph()->node(dagbase::NodeID(status.result));
+            ASSERT_NE(nullptr, node);
+
+            if (previous[i] != nullptr)
+            {
+                ASSERT_EQ(dagbase::Status::STATUS_OK, editor.connect(previous[i]->id(), node->dynamicPort(0)->id()).status);
+            }
+            else
+            {
+                static_cast<dagbase::TypedPort<double>*>(node->dynamicPort(0))->setValue(0.001 * double(i + 1));
+            }
+            previous[i] = node->dynamicPort(2);
+        }
+    }
+}
+
+class NodeEditorLiveTest_testEvaluateParallel : public ::testing::TestWithParam<std::tuple<std::size_t, std::size_t, std::size_t, dag::EvaluationPlan::Scheduler>>
+{
+};
+
+TEST_P(NodeEditorLiveTest_testEvaluateParallel, testMatchesSerial)
+{
+    std::size_t width = std::get<0>(GetParam());
+    std::size_t depth = std::get<1>(GetParam());
+    std::size_t numThreads = std::get<2>(GetParam());
+    dag::EvaluationPlan::Scheduler scheduler = std::get<3>(GetParam());
+
+    dag::NodeEditorLive serial;
+    buildMathsLayers(serial, width, depth);
+    dag::NodeEditorLive sut;
+    buildMathsLayers(sut, width, depth);
+    sut.setNumThreads(numThreads);
+    sut.setScheduler(scheduler);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, serial.evaluate().status);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.evaluate().status);
+    assertComparison(dagbase::Variant(std::uint32_t(depth)), sut.find("plan.numLevels"), 0.0, dagbase::ConfigurationElement::RELOP_EQ, "plan.numLevels");
+    for (std::size_t i=0; i<width*depth; ++i)
+    {
+        auto expected = static_cast<dagbase::TypedPort<double>*>(serial.rootGraph()->node(dagbase::NodeID(i))->dynamicPort(2));
+        auto actual = static_cast<dagbase::TypedPort<double>*>(sut.rootGraph()->node(dagbase::NodeID(i))->dynamicPort(2));
+        EXPECT_EQ(expected->value(), actual->value());
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(NodeEditorLive, NodeEditorLiveTest_testEvaluateParallel, ::testing::Values(
+        std::make_tuple(4, 3, 2, dag::EvaluationPlan::SCHEDULER_LEVELS),
+        std::make_tuple(100, 4, 1, dag::EvaluationPlan::SCHEDULER_LEVELS),
+        std::make_tuple(100, 4, 2, dag::EvaluationPlan::SCHEDULER_LEVELS),
+        std::make_tuple(100, 4, 4, dag::EvaluationPlan::SCHEDULER_LEVELS),
+        std::make_tuple(257, 5, 0, dag::EvaluationPlan::SCHEDULER_LEVELS),
+        std::make_tuple(4, 3, 2, dag::EvaluationPlan::SCHEDULER_DATAFLOW),
+        std::make_tuple(100, 4, 1, dag::EvaluationPlan::SCHEDULER_DATAFLOW),
+        std::make_tuple(100, 4, 4, dag::EvaluationPlan::SCHEDULER_DATAFLOW),
+        std::make_tuple(257, 5, 0, dag::EvaluationPlan::SCHEDULER_DATAFLOW),
+        std::make_tuple(4, 3, 2, dag::EvaluationPlan::SCHEDULER_CRITICAL_PATH),
+        std::make_tuple(100, 4, 4, dag::EvaluationPlan::SCHEDULER_CRITICAL_PATH),
+        std::make_tuple(257, 5, 0, dag::EvaluationPlan::SCHEDULER_CRITICAL_PATH)
+        ));
+
+TEST(NodeEditorLiveTest, testCriticalPathLength)
+{
+    dag::NodeEditorLive sut;
+    buildMathsLayers(sut, 4, 3);
+    // A branch off the first column is longer than any column.
+    dagbase::Port* previous = sut.rootGraph()->node(dagbase::NodeID(0))->dynamicPort(2);
+    for (std::size_t i=0; i<5; ++i)
+    {
+        auto node = sut.rootGraph()->node(dagbase::NodeID(sut.createNode("MathsNode", "branch" + std::to_string(i)).result));
+        ASSERT_EQ(dagbase::Status::STATUS_OK, sut.connect(previous->id(), node->dynamicPort(0)->id()).status);
+        previous = node->dynamicPort(2);
+    }
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.evaluate().status);
+    assertComparison(dagbase::Variant(std::int64_t(6)), sut.find("plan.criticalPathLength"), 0.0, dagbase::ConfigurationElement::RELOP_EQ, "plan.criticalPathLength");
+    sut.setNumThreads(2);
+    sut.setScheduler(dag::EvaluationPlan::SCHEDULER_CRITICAL_PATH);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.evaluate().status);
+    auto actual = static_cast<dagbase::TypedPort<double>*>(previous);
+    EXPECT_EQ(std::sin(std::sin(std::sin(std::sin(std::sin(std::sin(0.001)))))), actual->value());
+}
+
+TEST(NodeEditorLiveTest, testEvaluateForOnlyUpdatesUpstream)
+{
+    dag::NodeEditorLive sut;
+    buildMathsLayers(sut, 2, 3);
+    // Column 0 is Nodes 0, 2 and 4; column 1 is Nodes 1, 3 and 5.
+    auto probe = sut.rootGraph()->node(dagbase::NodeID(2))->dynamicPort(2);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.evaluateFor(probe->id()).status);
+    EXPECT_EQ(std::sin(std::sin(0.001)), static_cast<dagbase::TypedPort<double>*>(probe)->value());
+    EXPECT_EQ(0.0, static_cast<dagbase::TypedPort<double>*>(sut.rootGraph()->node(dagbase::NodeID(4))->dynamicPort(2))->value());
+    EXPECT_EQ(0.0, static_cast<dagbase::TypedPort<double>*>(sut.rootGraph()->node(dagbase::NodeID(1))->dynamicPort(2))->value());
+}
+
+class NodeEditorLiveTest_testEvaluateBatch : public ::testing::TestWithParam<std::tuple<std::size_t, std::size_t, std::size_t>>
+{
+};
+
+TEST_P(NodeEditorLiveTest_testEvaluateBatch, testMatchesScalar)
+{
+    std::size_t width = std::get<0>(GetParam());
+    std::size_t depth = std::get<1>(GetParam());
+    std::size_t batchSize = std::get<2>(GetParam());
+
+    dag::NodeEditorLive sut;
+    buildMathsLayers(sut, width, depth);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.prepareBatch(batchSize).status);
+    for (std::size_t i=0; i<width; ++i)
+    {
+        double* angles = sut.batchDoubles(sut.rootGraph()->node(dagbase::NodeID(i))->dynamicPort(0)->id());
+        ASSERT_NE(nullptr, angles);
+        for (std::size_t sample=0; sample<batchSize; ++sample)
+        {
+            angles[sample] = 0.01 * double(sample) + 0.1 * double(i);
+        }
+    }
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.evaluateBatch().status);
+    for (std::size_t i=0; i<width; ++i)
+    {
+        auto last = sut.rootGraph()->node(dagbase::NodeID((depth - 1) * width + i));
+        const double* outputs = sut.batchDoubles(last->dynamicPort(2)->id());
+        ASSERT_NE(nullptr, outputs);
+        for (std::size_t sample=0; sample<batchSize; ++sample)
+        {
+            double expected = 0.01 * double(sample) + 0.1 * double(i);
+            for (std::size_t layer=0; layer<depth; ++layer)
+            {
+                expected = std::sin(expected);
+            }
+            EXPECT_EQ(expected, outputs[sample]);
+        }
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(NodeEditorLive, NodeEditorLiveTest_testEvaluateBatch, ::testing::Values(
+        std::make_tuple(1, 1, 1),
+        std::make_tuple(2, 3, 7),
+        std::make_tuple(4, 2, 64)
+        ));
+
+TEST(NodeEditorLiveTest, testEvaluateBatchScalarFallback)
+{
+    dag::NodeEditorLive sut;
+    auto maths = sut.rootGraph()->node(dagbase::NodeID(sut.createNode("MathsNode", "maths1").result));
+    auto group = sut.rootGraph()->node(dagbase::NodeID(sut.createNode("GroupTyped", "group1").result));
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.connect(maths->dynamicPort(2)->id(), group->dynamicPort(1)->id()).status);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.prepareBatch(3).status);
+    double* angles = sut.batchDoubles(maths->dynamicPort(0)->id());
+    ASSERT_NE(nullptr, angles);
+    angles[0] = 0.0;
+    angles[1] = 0.5;
+    angles[2] = 1.0;
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.evaluateBatch().status);
+    const double* inputs = sut.batchDoubles(group->dynamicPort(1)->id());
+    ASSERT_NE(nullptr, inputs);
+    EXPECT_EQ(std::sin(0.0), inputs[0]);
+    EXPECT_EQ(std::sin(0.5), inputs[1]);
+    EXPECT_EQ(std::sin(1.0), inputs[2]);
+    // An edit discards the batch.
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.createNode("MathsNode", "maths2").status);
+    EXPECT_EQ(dagbase::Status::STATUS_OBJECT_NOT_FOUND, sut.evaluateBatch().status);
+}
+
+TEST(NodeEditorLiveTest, testZeroCopyBatch)
+{
+    dag::NodeEditorLive sut;
+    buildMathsLayers(sut, 2, 3);
+    auto producer = sut.rootGraph()->node(dagbase::NodeID(0))->dynamicPort(2)->id();
+    auto consumer = sut.rootGraph()->node(dagbase::NodeID(2))->dynamicPort(0)->id();
+    auto last = sut.rootGraph()->node(dagbase::NodeID(4))->dynamicPort(2)->id();
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.prepareBatch(4).status);
+    assertComparison(dagbase::Variant(std::uint32_t(4)), sut.find("plan.numAliased"), 0.0, dagbase::ConfigurationElement::RELOP_EQ, "plan.numAliased");
+    // The input reads the array of the output connected to it.
+    EXPECT_EQ(sut.batchDoubles(producer), sut.batchDoubles(consumer));
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.evaluateBatch().status);
+    std::vector<double> shared(sut.batchDoubles(last), sut.batchDoubles(last) + 4);
+    sut.setZeroCopy(false);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.prepareBatch(4).status);
+    assertComparison(dagbase::Variant(std::uint32_t(0)), sut.find("plan.numAliased"), 0.0, dagbase::ConfigurationElement::RELOP_EQ, "plan.numAliased");
+    EXPECT_NE(sut.batchDoubles(producer), sut.batchDoubles(consumer));
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.evaluateBatch().status);
+    for (std::size_t sample=0; sample<4; ++sample)
+    {
+        EXPECT_EQ(shared[sample], sut.batchDoubles(last)[sample]);
+    }
+}
+
+TEST(NodeEditorLiveTest, testTransfersAreDeletedWithTheirSignalPath)
+{
+    dag::NodeEditorLive sut;
+    buildMathsLayers(sut, 2, 2);
+    auto spare = sut.rootGraph()->node(dagbase::NodeID(sut.createNode("MathsNode", "spare").result));
+    auto first = sut.rootGraph()->node(dagbase::NodeID(0));
+    assertComparison(dagbase::Variant(std::uint32_t(2)), sut.find("numTransfers"), 0.0, dagbase::ConfigurationElement::RELOP_EQ, "numTransfers");
+    for (std::size_t i=0; i<10; ++i)
+    {
+        auto status = sut.connect(spare->dynamicPort(2)->id(), first->dynamicPort(0)->id());
+        ASSERT_EQ(dagbase::Status::STATUS_OK, status.status);
+        ASSERT_EQ(dagbase::Status::STATUS_OK, sut.disconnect(dagbase::SignalPathID(status.result)).status);
+    }
+    assertComparison(dagbase::Variant(std::uint32_t(2)), sut.find("numTransfers"), 0.0, dagbase::ConfigurationElement::RELOP_EQ, "numTransfers");
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.deleteNode(dagbase::NodeID(3)).status);
+    assertComparison(dagbase::Variant(std::uint32_t(1)), sut.find("numTransfers"), 0.0, dagbase::ConfigurationElement::RELOP_EQ, "numTransfers");
+}
+
+TEST(PortTransferTest, testConvertingCopy)
+{
+    dagbase::TypedPort<std::int64_t> int64Out(dagbase::PortID(1), nullptr, "int64Out", dagbase::PortType::TYPE_INT64, dagbase::PortDirection::DIR_OUT, 3);
+    dagbase::TypedPort<bool> boolOut(dagbase::PortID(2), nullptr, "boolOut", dagbase::PortType::TYPE_BOOL, dagbase::PortDirection::DIR_OUT, true);
+    dagbase::TypedPort<double> doubleIn(dagbase::PortID(3), nullptr, "doubleIn", dagbase::PortType::TYPE_DOUBLE, dagbase::PortDirection::DIR_IN, 0.0);
+    dagbase::TypedPort<std::int64_t> int64In(dagbase::PortID(4), nullptr, "int64In", dagbase::PortType::TYPE_INT64, dagbase::PortDirection::DIR_IN, 0);
+
+    dag::PortTransfer intToDouble{&int64Out, &doubleIn, dag::PortTransfer::selectCopy(int64Out, doubleIn), dag::PortTransfer::selectEqual(int64Out, doubleIn)};
+    EXPECT_FALSE(intToDouble.isCurrent());
+    intToDouble.makeItSo();
+    EXPECT_EQ(3.0, doubleIn.value());
+    EXPECT_TRUE(intToDouble.isCurrent());
+
+    dag::PortTransfer boolToDouble{&boolOut, &doubleIn, dag::PortTransfer::selectCopy(boolOut, doubleIn), dag::PortTransfer::selectEqual(boolOut, doubleIn)};
+    boolToDouble.makeItSo();
+    EXPECT_EQ(1.0, doubleIn.value());
+    EXPECT_TRUE(boolToDouble.isCurrent());
+
+    dag::PortTransfer boolToInt{&boolOut, &int64In, dag::PortTransfer::selectCopy(boolOut, int64In), dag::PortTransfer::selectEqual(boolOut, int64In)};
+    boolToInt.makeItSo();
+    EXPECT_EQ(1, int64In.value());
+    boolOut.setValue(false);
+    EXPECT_FALSE(boolToInt.isCurrent());
+    boolToInt.makeItSo();
+    EXPECT_EQ(0, int64In.value());
+}
+
+class FastMathTest_testAccuracy : public ::testing::TestWithParam<std::tuple<dag::FastMath::Accuracy, double, double>>
+{
+};
+
+TEST_P(FastMathTest_testAccuracy, testMatchesStd)
+{
+    dag::FastMath::Accuracy accuracy = std::get<0>(GetParam());
+    double ulps = std::get<1>(GetParam());
+    double absolute = std::get<2>(GetParam());
+
+    std::vector<double> x;
+    for (double angle=-1000.0; angle<1000.0; angle+=0.0137)
+    {
+        x.emplace_back(angle);
+    }
+    // Past the reduction limit the array functions fall back to std::sin and std::cos.
+    x.emplace_back(3.0e7);
+    x.emplace_back(-1.0e12);
+    std::vector<double> sines(x.size());
+    std::vector<double> cosines(x.size());
+    dag::FastMath::sin(x.data(), sines.data(), x.size(), 1.0, accuracy);
+    dag::FastMath::cos(x.data(), cosines.data(), x.size(), 1.0, accuracy);
+    auto tolerance = [ulps, absolute](double expected)
+    {
+        return ulps * (std::nextafter(std::abs(expected), INFINITY) - std::abs(expected)) + absolute;
+    };
+    for (std::size_t i=0; i<x.size(); ++i)
+    {
+        EXPECT_NEAR(std::sin(x[i]), sines[i], tolerance(std::sin(x[i])));
+        EXPECT_NEAR(std::cos(x[i]), cosines[i], tolerance(std::cos(x[i])));
+        EXPECT_NEAR(std::sin(x[i]), dag::FastMath::sin(x[i], accuracy), tolerance(std::sin(x[i])));
+        EXPECT_NEAR(std::cos(x[i]), dag::FastMath::cos(x[i], accuracy), tolerance(std::cos(x[i])));
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(FastMath, FastMathTest_testAccuracy, ::testing::Values(
+        std::make_tuple(dag::FastMath::ACCURACY_EXACT, 0.0, 0.0),
+        std::make_tuple(dag::FastMath::ACCURACY_ULP, 1.0, 0.0),
+        std::make_tuple(dag::FastMath::ACCURACY_FAST, 0.0, 1.0e-6)
+        ));
+
+TEST(MathsNodeTest, testUnitIsAppliedInTheKernel)
+{
+    dag::NodeEditorLive sut;
+    auto node = sut.rootGraph()->node(dagbase::NodeID(sut.createNode("MathsNode", "maths1").result));
+    auto maths = dynamic_cast<dag::MathsNode*>(node);
+    ASSERT_NE(nullptr, maths);
+    auto unit = static_cast<dagbase::TypedPort<std::int64_t>*>(node->dynamicPort(1));
+    for (auto accuracy : {dag::FastMath::ACCURACY_EXACT, dag::FastMath::ACCURACY_ULP, dag::FastMath::ACCURACY_FAST})
+    {
+        maths->setAccuracy(accuracy);
+        unit->setValue(dag::MathsNode::UNIT_DEGREES);
+        maths->angle()->setValue(30.0);
+        ASSERT_EQ(dagbase::Status::STATUS_OK, sut.evaluate().status);
+        EXPECT_NEAR(0.5, maths->output()->value(), 1.0e-6);
+        unit->setValue(dag::MathsNode::UNIT_GRADIANS);
+        maths->angle()->setValue(100.0);
+        ASSERT_EQ(dagbase::Status::STATUS_OK, sut.evaluate().status);
+        EXPECT_NEAR(1.0, maths->output()->value(), 1.0e-6);
+        unit->setValue(dag::MathsNode::UNIT_RADIANS);
+        ASSERT_EQ(dagbase::Status::STATUS_OK, sut.evaluate().status);
+        EXPECT_NEAR(std::sin(100.0), maths->output()->value(), 1.0e-6);
+    }
+}
+
+class NodeEditorLiveTest_testEvaluateChild : public ::testing::TestWithParam<std::tuple<bool, std::uint32_t, std::uint32_t>>
+{
+};
+
+TEST_P(NodeEditorLiveTest_testEvaluateChild, testEvaluateChild)
+{
+    bool flatten = std::get<0>(GetParam());
+    std::uint32_t numNodes = std::get<1>(GetParam());
+    std::uint32_t numTransfers = std::get<2>(GetParam());
+
+    dag::NodeEditorLive sut;
+    sut.setFlattenBoundaries(flatten);
+    auto bar = sut.rootGraph()->node(dagbase::NodeID(sut.createNode("BarTyped", "bar1").result));
+    auto maths = sut.rootGraph()->node(dagbase::NodeID(sut.createNode("MathsNode", "maths1").result));
+    auto foo = sut.rootGraph()->node(dagbase::NodeID(sut.createNode("FooTyped", "foo1").result));
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.connect(bar->dynamicPort(0)->id(), maths->dynamicPort(0)->id()).status);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.connect(maths->dynamicPort(2)->id(), foo->dynamicPort(0)->id()).status);
+    dag::SelectionInterface::Cont selection;
+    selection.emplace(maths);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.select(dag::NodeEditorInterface::SELECTION_SET, selection).status);
+    auto status = sut.createChild();
+    ASSERT_EQ(dagbase::Status::STATUS_OK, status.status);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.evaluate().status);
+    assertComparison(dagbase::Variant(numNodes), sut.find("plan.numNodes"), 0.0, dagbase::ConfigurationElement::RELOP_EQ, "plan.numNodes");
+    assertComparison(dagbase::Variant(numTransfers), sut.find("plan.numTransfers"), 0.0, dagbase::ConfigurationElement::RELOP_EQ, "plan.numTransfers");
+    auto actual = dynamic_cast<dagbase::TypedPort<double>*>(foo->dynamicPort(0));
+    ASSERT_NE(nullptr, actual);
+    EXPECT_EQ(std::sin(1.0), actual->value());
+
+    // The output of the GraphNode is brought up to date on demand.
+    auto graphNode = sut.rootGraph()->node(dagbase::NodeID(status.result));
+    ASSERT_NE(nullptr, graphNode);
+    for (std::size_t i=0; i<graphNode->totalPorts(); ++i)
+    {
+        auto port = graphNode->dynamicPort(i);
+        if (port->dir() == dagbase::PortDirection::DIR_OUT)
+        {
+            ASSERT_EQ(dagbase::Status::STATUS_OK, sut.evaluateFor(port->id()).status);
+            EXPECT_EQ(std::sin(1.0), static_cast<dagbase::TypedPort<double>*>(port)->value());
+        }
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(NodeEditorLive, NodeEditorLiveTest_testEvaluateChild, ::testing::Values(
+        std::make_tuple(true, 3, 2),
+        std::make_tuple(false, 5, 4)
+        ));
+
+TEST(NodeEditorLiveTest, testMemoiseChild)
+{
+    dag::NodeEditorLive sut;
+    auto bar = sut.rootGraph()->node(dagbase::NodeID(sut.createNode("BarTyped", "bar1").result));
+    auto maths = sut.rootGraph()->node(dagbase::NodeID(sut.createNode("MathsNode", "maths1").result));
+    auto foo = sut.rootGraph()->node(dagbase::NodeID(sut.createNode("FooTyped", "foo1").result));
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.connect(bar->dynamicPort(0)->id(), maths->dynamicPort(0)->id()).status);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.connect(maths->dynamicPort(2)->id(), foo->dynamicPort(0)->id()).status);
+    EXPECT_EQ(dagbase::Status::STATUS_OBJECT_NOT_FOUND, sut.setMemoise(maths->id(), 2).status);
+    dag::SelectionInterface::Cont selection;
+    selection.emplace(maths);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.select(dag::NodeEditorInterface::SELECTION_SET, selection).status);
+    auto status = sut.createChild();
+    ASSERT_EQ(dagbase::Status::STATUS_OK, status.status);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.setMemoise(dagbase::NodeID(status.result), 2).status);
+    auto input = bar->dynamicPort(0)->id();
+    auto actual = static_cast<dagbase::TypedPort<double>*>(foo->dynamicPort(0));
+    auto inner = static_cast<dagbase::TypedPort<double>*>(maths->dynamicPort(2));
+
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.evaluate().status);
+    assertComparison(dagbase::Variant(std::uint32_t(1)), sut.find("plan.numMemos"), 0.0, dagbase::ConfigurationElement::RELOP_EQ, "plan.numMemos");
+    assertComparison(dagbase::Variant(std::uint32_t(1)), sut.find("plan.numMemoMisses"), 0.0, dagbase::ConfigurationElement::RELOP_EQ, "plan.numMemoMisses");
+    EXPECT_EQ(std::sin(1.0), actual->value());
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.evaluate().status);
+    assertComparison(dagbase::Variant(std::uint32_t(1)), sut.find("plan.numMemoHits"), 0.0, dagbase::ConfigurationElement::RELOP_EQ, "plan.numMemoHits");
+    EXPECT_EQ(std::sin(1.0), actual->value());
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.setValue(input, dagbase::Value(0.5)).status);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.evaluate().status);
+    assertComparison(dagbase::Variant(std::uint32_t(2)), sut.find("plan.numMemoMisses"), 0.0, dagbase::ConfigurationElement::RELOP_EQ, "plan.numMemoMisses");
+    EXPECT_EQ(std::sin(0.5), actual->value());
+    // A hit restores the outputs without evaluating the child Graph.
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.setValue(input, dagbase::Value(1.0)).status);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.evaluate().status);
+    assertComparison(dagbase::Variant(std::uint32_t(2)), sut.find("plan.numMemoHits"), 0.0, dagbase::ConfigurationElement::RELOP_EQ, "plan.numMemoHits");
+    EXPECT_EQ(std::sin(1.0), actual->value());
+    EXPECT_EQ(std::sin(0.5), inner->value());
+    // Profiled evaluation takes the same path, so it hits the cache too.
+    sut.setProfiling(true);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.evaluate().status);
+    assertComparison(dagbase::Variant(std::uint32_t(3)), sut.find("plan.numMemoHits"), 0.0, dagbase::ConfigurationElement::RELOP_EQ, "plan.numMemoHits");
+    EXPECT_EQ(std::sin(1.0), actual->value());
+}
+
+TEST(NodeEditorLiveTest, testMemoiseChildWhoseExitSortsFirst)
+{
+    dag::NodeEditorLive sut;
+    auto bar1 = sut.rootGraph()->node(dagbase::NodeID(sut.createNode("BarTyped", "bar1").result));
+    auto maths1 = sut.rootGraph()->node(dagbase::NodeID(sut.createNode("MathsNode", "maths1").result));
+    auto maths2 = sut.rootGraph()->node(dagbase::NodeID(sut.createNode("MathsNode", "maths2").result));
+    auto inner = sut.rootGraph()->node(dagbase::NodeID(sut.createNode("MathsNode", "inner").result));
+    auto bar2 = sut.rootGraph()->node(dagbase::NodeID(sut.createNode("BarTyped", "bar2").result));
+    auto foo = sut.rootGraph()->node(dagbase::NodeID(sut.createNode("FooTyped", "foo1").result));
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.connect(bar1->dynamicPort(0)->id(), maths1->dynamicPort(0)->id()).status);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.connect(maths1->dynamicPort(2)->id(), maths2->dynamicPort(0)->id()).status);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.connect(maths2->dynamicPort(2)->id(), inner->dynamicPort(0)->id()).status);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.connect(bar2->dynamicPort(0)->id(), foo->dynamicPort(0)->id()).status);
+    // The output of the child does not depend on its input, which arrives through a longer chain,
+    // so the output Boundary comes before the input Boundary in the plan.
+    dag::SelectionInterface::Cont selection;
+    selection.emplace(inner);
+    selection.emplace(bar2);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.select(dag::NodeEditorInterface::SELECTION_SET, selection).status);
+    auto status = sut.createChild();
+    ASSERT_EQ(dagbase::Status::STATUS_OK, status.status);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.setMemoise(dagbase::NodeID(status.result), 2).status);
+    const std::string memo = "plan.memos[" + std::to_string(status.result) + "]";
+    auto input = bar1->dynamicPort(0)->id();
+    auto actual = static_cast<dagbase::TypedPort<double>*>(foo->dynamicPort(0));
+    auto output = static_cast<dagbase::TypedPort<double>*>(inner->dynamicPort(2));
+
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.evaluate().status);
+    assertComparison(dagbase::Variant(std::uint32_t(1)), sut.find("plan.numMemos"), 0.0, dagbase::ConfigurationElement::RELOP_EQ, "plan.numMemos");
+    assertComparison(dagbase::Variant(std::uint32_t(1)), sut.find(memo + ".numMisses"), 0.0, dagbase::ConfigurationElement::RELOP_EQ, memo + ".numMisses");
+    EXPECT_EQ(std::sin(std::sin(std::sin(1.0))), output->value());
+    // The outputs were cached even though the exit ran first.
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.evaluate().status);
+    assertComparison(dagbase::Variant(std::uint32_t(1)), sut.find(memo + ".numHits"), 0.0, dagbase::ConfigurationElement::RELOP_EQ, memo + ".numHits");
+    EXPECT_EQ(1.0, actual->value());
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.setValue(input, dagbase::Value(0.5)).status);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.evaluate().status);
+    assertComparison(dagbase::Variant(std::uint32_t(2)), sut.find(memo + ".numMisses"), 0.0, dagbase::ConfigurationElement::RELOP_EQ, memo + ".numMisses");
+    EXPECT_EQ(std::sin(std::sin(std::sin(0.5))), output->value());
+    // A hit skips the Node that depends on the input.
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.setValue(input, dagbase::Value(1.0)).status);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.evaluate().status);
+    assertComparison(dagbase::Variant(std::uint32_t(2)), sut.find(memo + ".numHits"), 0.0, dagbase::ConfigurationElement::RELOP_EQ, memo + ".numHits");
+    EXPECT_EQ(std::sin(std::sin(std::sin(0.5))), output->value());
+    EXPECT_EQ(1.0, actual->value());
+}
+
+TEST(NodeEditorLiveTest, testConditionGatesDownstream)
+{
+    dag::NodeEditorLive sut;
+    auto condition = sut.rootGraph()->node(dagbase::NodeID(sut.createNode("Derived", "derived1").result));
+    auto maths = sut.rootGraph()->node(dagbase::NodeID(sut.createNode("MathsNode", "maths1").result));
+    auto foo = sut.rootGraph()->node(dagbase::NodeID(sut.createNode("FooTyped", "foo1").result));
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.connect(condition->dynamicPort(0)->id(), maths->dynamicPort(0)->id()).status);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.connect(maths->dynamicPort(2)->id(), foo->dynamicPort(0)->id()).status);
+    auto direction = condition->dynamicPort(0)->id();
+    auto trigger = static_cast<dagbase::TypedPort<bool>*>(condition->dynamicPort(1));
+    auto actual = static_cast<dagbase::TypedPort<double>*>(foo->dynamicPort(0));
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.setValue(direction, dagbase::Value(0.5)).status);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.evaluate().status);
+    assertComparison(dagbase::Variant(std::uint32_t(1)), sut.find("plan.numConditions"), 0.0, dagbase::ConfigurationElement::RELOP_EQ, "plan.numConditions");
+    assertComparison(dagbase::Variant(std::uint32_t(2)), sut.find("plan.numGated"), 0.0, dagbase::ConfigurationElement::RELOP_EQ, "plan.numGated");
+    EXPECT_EQ(std::sin(0.5), actual->value());
+    // A closed gate skips the whole region, which keeps its previous outputs.
+    trigger->setValue(false);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.setValue(direction, dagbase::Value(1.0)).status);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.evaluate().status);
+    EXPECT_EQ(std::sin(0.5), actual->value());
+    trigger->setValue(true);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.evaluate().status);
+    EXPECT_EQ(std::sin(1.0), actual->value());
+}
+
+TEST(NodeEditorLiveTest, testConditionMixedJoin)
+{
+    dag::NodeEditorLive sut;
+    // Keep the input Boundary of the child, which joins a gated branch to an ungated one.
+    sut.setFlattenBoundaries(false);
+    auto condition = sut.rootGraph()->node(dagbase::NodeID(sut.createNode("Derived", "derived1").result));
+    auto bar = sut.rootGraph()->node(dagbase::NodeID(sut.createNode("BarTyped", "bar1").result));
+    auto gated = sut.rootGraph()->node(dagbase::NodeID(sut.createNode("MathsNode", "gated").result));
+    auto ungated = sut.rootGraph()->node(dagbase::NodeID(sut.createNode("MathsNode", "ungated").result));
+    auto innerGated = sut.rootGraph()->node(dagbase::NodeID(sut.createNode("MathsNode", "innerGated").result));
+    auto innerUngated = sut.rootGraph()->node(dagbase::NodeID(sut.createNode("MathsNode", "innerUngated").result));
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.connect(condition->dynamicPort(0)->id(), gated->dynamicPort(0)->id()).status);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.connect(bar->dynamicPort(0)->id(), ungated->dynamicPort(0)->id()).status);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.connect(gated->dynamicPort(2)->id(), innerGated->dynamicPort(0)->id()).status);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.connect(ungated->dynamicPort(2)->id(), innerUngated->dynamicPort(0)->id()).status);
+    dag::SelectionInterface::Cont selection;
+    selection.emplace(innerGated);
+    selection.emplace(innerUngated);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.select(dag::NodeEditorInterface::SELECTION_SET, selection).status);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.createChild().status);
+    auto trigger = static_cast<dagbase::TypedPort<bool>*>(condition->dynamicPort(1));
+    auto held = static_cast<dagbase::TypedPort<double>*>(innerGated->dynamicPort(2));
+    auto actual = static_cast<dagbase::TypedPort<double>*>(innerUngated->dynamicPort(2));
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.evaluate().status);
+    EXPECT_EQ(std::sin(std::sin(1.0)), actual->value());
+    const double before = held->value();
+    // The join still runs with the gate closed, the gated branch keeps its previous output.
+    trigger->setValue(false);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.setValue(bar->dynamicPort(0)->id(), dagbase::Value(0.5)).status);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.evaluate().status);
+    EXPECT_EQ(std::sin(std::sin(0.5)), actual->value());
+    EXPECT_EQ(before, held->value());
+}
+
+TEST(NodeEditorLiveTest, testMultiRate)
+{
+    dag::NodeEditorLive sut;
+    auto fast = sut.rootGraph()->node(dagbase::NodeID(sut.createNode("MathsNode", "fast").result));
+    auto slow = sut.rootGraph()->node(dagbase::NodeID(sut.createNode("MathsNode", "slow").result));
+    auto held = sut.rootGraph()->node(dagbase::NodeID(sut.createNode("MathsNode", "held").result));
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.connect(fast->dynamicPort(2)->id(), slow->dynamicPort(0)->id()).status);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.connect(slow->dynamicPort(2)->id(), held->dynamicPort(0)->id()).status);
+    EXPECT_EQ(dagbase::Status::STATUS_OBJECT_NOT_FOUND, sut.setDivisor(dagbase::NodeID(100), 2).status);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.setDivisor(slow->id(), 2).status);
+    auto input = fast->dynamicPort(0)->id();
+    auto actual = static_cast<dagbase::TypedPort<double>*>(held->dynamicPort(2));
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.setValue(input, dagbase::Value(0.5)).status);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.evaluate().status);
+    assertComparison(dagbase::Variant(std::uint32_t(3)), sut.find("plan.numDue"), 0.0, dagbase::ConfigurationElement::RELOP_EQ, "plan.numDue");
+    EXPECT_EQ(std::sin(std::sin(std::sin(0.5))), actual->value());
+    // The slow Node is not due, so the fast Node after it holds its last output.
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.setValue(input, dagbase::Value(1.0)).status);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.evaluate().status);
+    assertComparison(dagbase::Variant(std::uint32_t(2)), sut.find("plan.numDue"), 0.0, dagbase::ConfigurationElement::RELOP_EQ, "plan.numDue");
+    EXPECT_EQ(std::sin(std::sin(std::sin(0.5))), actual->value());
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.evaluate().status);
+    EXPECT_EQ(std::sin(std::sin(std::sin(1.0))), actual->value());
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.setDivisor(slow->id(), 1).status);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.evaluate().status);
+    assertComparison(dagbase::Variant(std::uint32_t(0)), sut.find("plan.numRates"), 0.0, dagbase::ConfigurationElement::RELOP_EQ, "plan.numRates");
+    // Threaded frames advance the tick and honour the divisor too.
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.setDivisor(slow->id(), 2).status);
+    sut.setNumThreads(4);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.setValue(input, dagbase::Value(0.25)).status);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.evaluate().status);
+    EXPECT_EQ(std::sin(std::sin(std::sin(0.25))), actual->value());
+    sut.setScheduler(dag::EvaluationPlan::SCHEDULER_DATAFLOW);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.setValue(input, dagbase::Value(0.5)).status);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.evaluate().status);
+    EXPECT_EQ(std::sin(std::sin(std::sin(0.25))), actual->value());
+    assertComparison(dagbase::Variant(std::int64_t(6)), sut.find("plan.tick"), 0.0, dagbase::ConfigurationElement::RELOP_EQ, "plan.tick");
+    // A dirty Node that is not due waits for the next frame in which it is.
+    sut.setNumThreads(1);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.setValue(input, dagbase::Value(1.0)).status);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.evaluateDirty().status);
+    EXPECT_EQ(std::sin(std::sin(std::sin(1.0))), actual->value());
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.setValue(input, dagbase::Value(0.5)).status);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.evaluateDirty().status);
+    EXPECT_EQ(std::sin(std::sin(std::sin(1.0))), actual->value());
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.evaluateDirty().status);
+    EXPECT_EQ(std::sin(std::sin(std::sin(0.5))), actual->value());
+    assertComparison(dagbase::Variant(std::int64_t(9)), sut.find("plan.tick"), 0.0, dagbase::ConfigurationElement::RELOP_EQ, "plan.tick");
+}
+
+TEST(NodeEditorLiveTest, testFeedbackThroughDelay)
+{
+    dag::NodeEditorLive sut;
+    auto delay = sut.rootGraph()->node(dagbase::NodeID(sut.createNode("Delay", "delay1").result));
+    auto maths = sut.rootGraph()->node(dagbase::NodeID(sut.createNode("MathsNode", "maths1").result));
+    ASSERT_NE(nullptr, delay);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.connect(delay->dynamicPort(1)->id(), maths->dynamicPort(0)->id()).status);
+    // Closing the loop through the Delay is not a cycle.
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.connect(maths->dynamicPort(2)->id(), delay->dynamicPort(0)->id()).status);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.setValue(delay->dynamicPort(0)->id(), dagbase::Value(0.5)).status);
+    auto actual = static_cast<dagbase::TypedPort<double>*>(maths->dynamicPort(2));
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.evaluate().status);
+    assertComparison(dagbase::Variant(std::uint32_t(1)), sut.find("plan.numFeedback"), 0.0, dagbase::ConfigurationElement::RELOP_EQ, "plan.numFeedback");
+    EXPECT_EQ(std::sin(0.5), actual->value());
+    // Each frame sees the output of the previous one.
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.evaluate().status);
+    EXPECT_EQ(std::sin(std::sin(0.5)), actual->value());
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.evaluate().status);
+    EXPECT_EQ(std::sin(std::sin(std::sin(0.5))), actual->value());
+}
+
+TEST(NodeEditorLiveTest, testConnectTracksChildGraphs)
+{
+    dag::NodeEditorLive sut;
+    auto maths1 = sut.rootGraph()->node(dagbase::NodeID(sut.createNode("MathsNode", "maths1").result));
+    auto inner = sut.rootGraph()->node(dagbase::NodeID(sut.createNode("MathsNode", "inner").result));
+    auto maths2 = sut.rootGraph()->node(dagbase::NodeID(sut.createNode("MathsNode", "maths2").result));
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.connect(maths1->dynamicPort(2)->id(), inner->dynamicPort(0)->id()).status);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.connect(inner->dynamicPort(2)->id(), maths2->dynamicPort(0)->id()).status);
+    dag::SelectionInterface::Cont selection;
+    selection.emplace(inner);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.select(dag::NodeEditorInterface::SELECTION_SET, selection).status);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.createChild().status);
+    // The path from maths1 to maths2 runs through the child Graph.
+    EXPECT_EQ(dagbase::Status::STATUS_CYCLE_DETECTED, sut.connect(maths2->dynamicPort(2)->id(), maths1->dynamicPort(0)->id()).status);
+    // The same loop through a Delay is accepted, as it is without a child Graph.
+    auto delay = sut.rootGraph()->node(dagbase::NodeID(sut.createNode("Delay", "delay1").result));
+    ASSERT_NE(nullptr, delay);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.connect(maths2->dynamicPort(2)->id(), delay->dynamicPort(0)->id()).status);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.connect(delay->dynamicPort(1)->id(), maths1->dynamicPort(0)->id()).status);
+    // One full sort after the child Graph was made, then each connection was tracked.
+    assertComparison(dagbase::Variant(std::uint32_t(1)), sut.find("order.numRebuilds"), 0.0, dagbase::ConfigurationElement::RELOP_EQ, "order.numRebuilds");
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.evaluate().status);
+    assertComparison(dagbase::Variant(std::uint32_t(1)), sut.find("plan.numFeedback"), 0.0, dagbase::ConfigurationElement::RELOP_EQ, "plan.numFeedback");
+}
+
+TEST(NodeEditorLiveTest, testFuseChains)
+{
+    dag::NodeEditorLive serial;
+    buildMathsLayers(serial, 3, 5);
+    dag::NodeEditorLive sut;
+    buildMathsLayers(sut, 3, 5);
+    sut.setFuseChains(true);
+    // A branch off the middle of a column starts a chain of its own.
+    auto branch = sut.rootGraph()->node(dagbase::NodeID(sut.createNode("MathsNode", "branch").result));
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.connect(sut.rootGraph()->node(dagbase::NodeID(3))->dynamicPort(2)->id(), branch->dynamicPort(0)->id()).status);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, serial.evaluate().status);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.evaluate().status);
+    assertComparison(dagbase::Variant(std::uint32_t(3)), sut.find("plan.numChains"), 0.0, dagbase::ConfigurationElement::RELOP_EQ, "plan.numChains");
+    assertComparison(dagbase::Variant(std::uint32_t(12)), sut.find("plan.numFused"), 0.0, dagbase::ConfigurationElement::RELOP_EQ, "plan.numFused");
+    // Every Port of a fused chain reads as if each Node had been updated.
+    for (std::size_t i=0; i<3*5; ++i)
+    {
+        for (std::size_t portIndex : {0, 2})
+        {
+            auto expected = static_cast<dagbase::TypedPort<double>*>(serial.rootGraph()->node(dagbase::NodeID(i))->dynamicPort(portIndex));
+            auto actual = static_cast<dagbase::TypedPort<double>*>(sut.rootGraph()->node(dagbase::NodeID(i))->dynamicPort(portIndex));
+            EXPECT_EQ(expected->value(), actual->value());
+        }
+    }
+    auto expected = static_cast<dagbase::TypedPort<double>*>(serial.rootGraph()->node(dagbase::NodeID(3))->dynamicPort(2));
+    EXPECT_EQ(std::sin(expected->value()), static_cast<dagbase::TypedPort<double>*>(branch->dynamicPort(2))->value());
+    // Heads run their chains in threaded, dataflow and profiled frames too.
+    sut.setNumThreads(4);
+    auto input = sut.rootGraph()->node(dagbase::NodeID(0))->dynamicPort(0)->id();
+    const dag::EvaluationPlan::Scheduler schedulers[] = {dag::EvaluationPlan::SCHEDULER_LEVELS, dag::EvaluationPlan::SCHEDULER_DATAFLOW};
+    for (std::size_t round=0; round<3; ++round)
+    {
+        const double value = 0.25 * double(round + 1);
+        sut.setScheduler(schedulers[round % 2]);
+        sut.setProfiling(round == 2);
+        ASSERT_EQ(dagbase::Status::STATUS_OK, serial.setValue(input, dagbase::Value(value)).status);
+        ASSERT_EQ(dagbase::Status::STATUS_OK, sut.setValue(input, dagbase::Value(value)).status);
+        ASSERT_EQ(dagbase::Status::STATUS_OK, serial.evaluate().status);
+        ASSERT_EQ(dagbase::Status::STATUS_OK, sut.evaluate().status);
+        assertComparison(dagbase::Variant(std::uint32_t(3)), sut.find("plan.numChains"), 0.0, dagbase::ConfigurationElement::RELOP_EQ, "plan.numChains");
+        for (std::size_t i=0; i<3*5; ++i)
+        {
+            auto expectedOutput = static_cast<dagbase::TypedPort<double>*>(serial.rootGraph()->node(dagbase::NodeID(i))->dynamicPort(2));
+            auto actualOutput = static_cast<dagbase::TypedPort<double>*>(sut.rootGraph()->node(dagbase::NodeID(i))->dynamicPort(2));
+            EXPECT_EQ(expectedOutput->value(), actualOutput->value());
+        }
+        EXPECT_EQ(std::sin(expected->value()), static_cast<dagbase::TypedPort<double>*>(branch->dynamicPort(2))->value());
+    }
+}
+
+TEST(NodeEditorLiveTest, testEvaluateWithin)
+{
+    dag::NodeEditorLive sut;
+    auto first = sut.rootGraph()->node(dagbase::NodeID(sut.createNode("MathsNode", "first").result));
+    auto second = sut.rootGraph()->node(dagbase::NodeID(sut.createNode("MathsNode", "second").result));
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.connect(first->dynamicPort(2)->id(), second->dynamicPort(0)->id()).status);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.setValue(first->dynamicPort(0)->id(), dagbase::Value(0.5)).status);
+    sut.setSnapshot(true);
+    auto output = second->dynamicPort(2)->id();
+    EXPECT_EQ(nullptr, sut.snapshotDoubles(output));
+    bool finished = true;
+    // A zero budget still runs one Node per call.
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.evaluateWithin(std::chrono::nanoseconds(0), finished).status);
+    EXPECT_FALSE(finished);
+    assertComparison(dagbase::Variant(std::uint32_t(1)), sut.find("cursor.next"), 0.0, dagbase::ConfigurationElement::RELOP_EQ, "cursor.next");
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.evaluateWithin(std::chrono::nanoseconds(0), finished).status);
+    EXPECT_TRUE(finished);
+    assertComparison(dagbase::Variant(std::uint32_t(1)), sut.find("cursor.numFrames"), 0.0, dagbase::ConfigurationElement::RELOP_EQ, "cursor.numFrames");
+    assertComparison(dagbase::Variant(std::uint32_t(2)), sut.find("cursor.numSlices"), 0.0, dagbase::ConfigurationElement::RELOP_EQ, "cursor.numSlices");
+    auto snapshot = sut.snapshotDoubles(output);
+    ASSERT_NE(nullptr, snapshot);
+    EXPECT_EQ(std::sin(std::sin(0.5)), *snapshot);
+    // The snapshot keeps the last whole frame while the next one is part way through.
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.setValue(first->dynamicPort(0)->id(), dagbase::Value(1.0)).status);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.evaluateWithin(std::chrono::nanoseconds(0), finished).status);
+    EXPECT_FALSE(finished);
+    EXPECT_EQ(std::sin(std::sin(0.5)), *sut.snapshotDoubles(output));
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.evaluateWithin(std::chrono::seconds(1), finished).status);
+    EXPECT_TRUE(finished);
+    EXPECT_EQ(std::sin(std::sin(1.0)), *sut.snapshotDoubles(output));
+}
+
+TEST(NodeEditorLiveTest, testFoldConstants)
+{
+    dag::NodeEditorLive sut;
+    sut.setFoldConstants(true);
+    auto a = sut.rootGraph()->node(dagbase::NodeID(sut.createNode("MathsNode", "a").result));
+    auto b = sut.rootGraph()->node(dagbase::NodeID(sut.createNode("MathsNode", "b").result));
+    auto bar = sut.rootGraph()->node(dagbase::NodeID(sut.createNode("BarTyped", "bar1").result));
+    auto c = sut.rootGraph()->node(dagbase::NodeID(sut.createNode("MathsNode", "c").result));
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.connect(a->dynamicPort(2)->id(), b->dynamicPort(0)->id()).status);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.connect(bar->dynamicPort(0)->id(), c->dynamicPort(0)->id()).status);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.setValue(a->dynamicPort(0)->id(), dagbase::Value(0.5)).status);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.evaluate().status);
+    // The source and the Node it feeds can change every frame.
+    assertComparison(dagbase::Variant(std::uint32_t(2)), sut.find("plan.numFolded"), 0.0, dagbase::ConfigurationElement::RELOP_EQ, "plan.numFolded");
+    auto output = static_cast<dagbase::TypedPort<double>*>(b->dynamicPort(2));
+    EXPECT_EQ(std::sin(std::sin(0.5)), output->value());
+    // setValue() unfolds.
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.setValue(a->dynamicPort(0)->id(), dagbase::Value(1.0)).status);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.evaluate().status);
+    EXPECT_EQ(std::sin(std::sin(1.0)), output->value());
+    // A direct write to a constant Node is not seen until something unfolds it.
+    static_cast<dagbase::TypedPort<double>*>(a->dynamicPort(0))->setValue(2.0);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.evaluate().status);
+    EXPECT_EQ(std::sin(std::sin(1.0)), output->value());
+    // An edit refolds.
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.createNode("MathsNode", "d").status);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.evaluate().status);
+    EXPECT_EQ(std::sin(std::sin(2.0)), output->value());
+}
+
+TEST(NodeEditorLiveTest, testUnfoldOnlyDownstream)
+{
+    dag::NodeEditorLive sut;
+    sut.setFoldConstants(true);
+    auto a = sut.rootGraph()->node(dagbase::NodeID(sut.createNode("MathsNode", "a").result));
+    auto b = sut.rootGraph()->node(dagbase::NodeID(sut.createNode("MathsNode", "b").result));
+    auto e = sut.rootGraph()->node(dagbase::NodeID(sut.createNode("MathsNode", "e").result));
+    auto f = sut.rootGraph()->node(dagbase::NodeID(sut.createNode("MathsNode", "f").result));
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.connect(a->dynamicPort(2)->id(), b->dynamicPort(0)->id()).status);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.connect(e->dynamicPort(2)->id(), f->dynamicPort(0)->id()).status);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.setValue(a->dynamicPort(0)->id(), dagbase::Value(0.5)).status);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.setValue(e->dynamicPort(0)->id(), dagbase::Value(0.5)).status);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.evaluate().status);
+    assertComparison(dagbase::Variant(std::uint32_t(4)), sut.find("plan.numFolded"), 0.0, dagbase::ConfigurationElement::RELOP_EQ, "plan.numFolded");
+    auto outputB = static_cast<dagbase::TypedPort<double>*>(b->dynamicPort(2));
+    auto outputF = static_cast<dagbase::TypedPort<double>*>(f->dynamicPort(2));
+    // The direct write to e shows whether e was unfolded along with a.
+    static_cast<dagbase::TypedPort<double>*>(e->dynamicPort(0))->setValue(2.0);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.setValue(a->dynamicPort(0)->id(), dagbase::Value(1.0)).status);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.evaluate().status);
+    EXPECT_EQ(std::sin(std::sin(1.0)), outputB->value());
+    EXPECT_EQ(std::sin(std::sin(0.5)), outputF->value());
+    // a and b refolded, so a direct write to a is not seen either.
+    static_cast<dagbase::TypedPort<double>*>(a->dynamicPort(0))->setValue(2.0);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.evaluate().status);
+    EXPECT_EQ(std::sin(std::sin(1.0)), outputB->value());
+}
+
+TEST(NodeEditorLiveTest, testEvaluateDirtySeesPrimitivePortWrites)
+{
+    dag::NodeEditorLive sut;
+    auto a = sut.rootGraph()->node(dagbase::NodeID(sut.createNode("MathsNode", "a").result));
+    auto b = sut.rootGraph()->node(dagbase::NodeID(sut.createNode("MathsNode", "b").result));
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.connect(a->dynamicPort(2)->id(), b->dynamicPort(0)->id()).status);
+    // A source outside the Graph, written directly by its owner.
+    dag::PrimitivePort<double> source(dagbase::PortID(1000), "source", dagbase::PortType::TYPE_DOUBLE, dagbase::PortDirection::DIR_OUT, 0.5);
+    auto transfer = source.connectTo(*a->dynamicPort(0));
+    ASSERT_NE(nullptr, transfer);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.evaluateDirty().status);
+    auto output = static_cast<dagbase::TypedPort<double>*>(b->dynamicPort(2));
+    EXPECT_EQ(std::sin(std::sin(0.5)), output->value());
+    source.setValue(1.0);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.evaluateDirty().status);
+    EXPECT_EQ(std::sin(std::sin(1.0)), output->value());
+    assertComparison(dagbase::Variant(std::uint32_t(2)), sut.find("plan.numUpdated"), 0.0, dagbase::ConfigurationElement::RELOP_EQ, "plan.numUpdated");
+    // Writing the same value is not a change.
+    source.setValue(1.0);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.evaluateDirty().status);
+    assertComparison(dagbase::Variant(std::uint32_t(0)), sut.find("plan.numUpdated"), 0.0, dagbase::ConfigurationElement::RELOP_EQ, "plan.numUpdated");
+    source.disconnect(*a->dynamicPort(0));
+    delete transfer;
+}
+
+TEST(NodeEditorLiveTest, testPruneDeadNodes)
+{
+    dag::NodeEditorLive sut;
+    sut.setPruneDeadNodes(true);
+    auto a = sut.rootGraph()->node(dagbase::NodeID(sut.createNode("MathsNode", "a").result));
+    auto b = sut.rootGraph()->node(dagbase::NodeID(sut.createNode("MathsNode", "b").result));
+    auto c = sut.rootGraph()->node(dagbase::NodeID(sut.createNode("MathsNode", "c").result));
+    auto bar = sut.rootGraph()->node(dagbase::NodeID(sut.createNode("BarTyped", "bar1").result));
+    auto foo = sut.rootGraph()->node(dagbase::NodeID(sut.createNode("FooTyped", "foo1").result));
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.connect(a->dynamicPort(2)->id(), b->dynamicPort(0)->id()).status);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.connect(bar->dynamicPort(0)->id(), foo->dynamicPort(0)->id()).status);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.setValue(a->dynamicPort(0)->id(), dagbase::Value(0.5)).status);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.setValue(c->dynamicPort(0)->id(), dagbase::Value(0.5)).status);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.evaluate().status);
+    // Only the sink and its source are live.
+    assertComparison(dagbase::Variant(std::uint32_t(2)), sut.find("plan.numLive"), 0.0, dagbase::ConfigurationElement::RELOP_EQ, "plan.numLive");
+    assertComparison(dagbase::Variant(std::uint32_t(3)), sut.find("plan.numPruned"), 0.0, dagbase::ConfigurationElement::RELOP_EQ, "plan.numPruned");
+    auto outputB = static_cast<dagbase::TypedPort<double>*>(b->dynamicPort(2));
+    auto outputC = static_cast<dagbase::TypedPort<double>*>(c->dynamicPort(2));
+    EXPECT_EQ(0.0, outputB->value());
+    EXPECT_EQ(0.0, outputC->value());
+    // Pinning the output of b keeps it and its producer alive.
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.pinPort(outputB->id()).status);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.evaluate().status);
+    assertComparison(dagbase::Variant(std::uint32_t(4)), sut.find("plan.numLive"), 0.0, dagbase::ConfigurationElement::RELOP_EQ, "plan.numLive");
+    EXPECT_EQ(std::sin(std::sin(0.5)), outputB->value());
+    EXPECT_EQ(0.0, outputC->value());
+    // Asking for a Port explicitly still evaluates a dead Node.
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.evaluateFor(outputC->id()).status);
+    EXPECT_EQ(std::sin(0.5), outputC->value());
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.unpinPort(outputB->id()).status);
+    assertComparison(dagbase::Variant(std::uint32_t(2)), sut.find("plan.numLive"), 0.0, dagbase::ConfigurationElement::RELOP_EQ, "plan.numLive");
+    EXPECT_EQ(dagbase::Status::STATUS_OBJECT_NOT_FOUND, sut.pinPort(dagbase::PortID(100)).status);
+}
+
+TEST(NodeEditorLiveTest, testProfileEvaluation)
+{
+    dag::NodeEditorLive sut;
+    auto a = sut.rootGraph()->node(dagbase::NodeID(sut.createNode("MathsNode", "a").result));
+    auto b = sut.rootGraph()->node(dagbase::NodeID(sut.createNode("MathsNode", "b").result));
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.connect(a->dynamicPort(2)->id(), b->dynamicPort(0)->id()).status);
+    EXPECT_EQ(nullptr, sut.profile());
+    sut.setProfiling(true);
+    for (int i=0; i<3; ++i)
+    {
+        ASSERT_EQ(dagbase::Status::STATUS_OK, sut.evaluate().status);
+    }
+    assertComparison(dagbase::Variant(std::int64_t(3)), sut.find("plan.tick"), 0.0, dagbase::ConfigurationElement::RELOP_EQ, "plan.tick");
+    assertComparison(dagbase::Variant(std::int64_t(3)), sut.find("profile.nodes[1].count"), 0.0, dagbase::ConfigurationElement::RELOP_EQ, "profile.nodes[1].count");
+    assertComparison(dagbase::Variant(std::int64_t(3)), sut.find("profile.transfers[" + std::to_string(std::uint32_t(b->dynamicPort(0)->id())) + "].count"), 0.0, dagbase::ConfigurationElement::RELOP_EQ, "profile.transfers[].count");
+    ASSERT_NE(nullptr, sut.profile());
+    // Two Nodes and one transfer.
+    auto hotList = sut.profile()->hotList(10);
+    ASSERT_EQ(3u, hotList.size());
+    EXPECT_GE(hotList[0].stats.totalNanos, hotList[2].stats.totalNanos);
+    std::ostringstream str;
+    sut.profile()->writeHotList(str, 1);
+    auto dump = str.str();
+    EXPECT_EQ(1, std::count(dump.begin(), dump.end(), '\n'));
+    // A recompile starts a new profile.
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.createNode("MathsNode", "c").status);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.evaluate().status);
+    assertComparison(dagbase::Variant(std::int64_t(1)), sut.find("profile.nodes[1].count"), 0.0, dagbase::ConfigurationElement::RELOP_EQ, "profile.nodes[1].count");
+    sut.setProfiling(false);
+    EXPECT_EQ(nullptr, sut.profile());
+}
+
+TEST(NodeEditorLiveTest, testEvaluateInstances)
+{
+    dag::NodeEditorLive sut;
+    auto a = sut.rootGraph()->node(dagbase::NodeID(sut.createNode("MathsNode", "a").result));
+    auto b = sut.rootGraph()->node(dagbase::NodeID(sut.createNode("MathsNode", "b").result));
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.connect(a->dynamicPort(2)->id(), b->dynamicPort(0)->id()).status);
+    EXPECT_EQ(dagbase::Status::STATUS_OBJECT_NOT_FOUND, sut.evaluateInstances().status);
+    const std::size_t numInstances = 4;
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.prepareInstances(numInstances).status);
+    assertComparison(dagbase::Variant(std::uint32_t(numInstances)), sut.find("numInstances"), 0.0, dagbase::ConfigurationElement::RELOP_EQ, "numInstances");
+    for (std::size_t i=0; i<numInstances; ++i)
+    {
+        auto angle = sut.instanceDoubles(i, a->dynamicPort(0)->id());
+        ASSERT_NE(nullptr, angle);
+        *angle = 0.1 * double(i);
+    }
+    EXPECT_EQ(nullptr, sut.instanceDoubles(numInstances, a->dynamicPort(0)->id()));
+    // The unit is an int64 Port, not a double.
+    EXPECT_EQ(nullptr, sut.instanceDoubles(0, a->dynamicPort(1)->id()));
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.evaluateInstances().status);
+    for (std::size_t i=0; i<numInstances; ++i)
+    {
+        auto output = sut.instanceDoubles(i, b->dynamicPort(2)->id());
+        ASSERT_NE(nullptr, output);
+        EXPECT_EQ(std::sin(std::sin(0.1 * double(i))), *output);
+    }
+    // An edit discards the instances.
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.createNode("MathsNode", "c").status);
+    EXPECT_EQ(dagbase::Status::STATUS_OBJECT_NOT_FOUND, sut.evaluateInstances().status);
+}
+
+TEST(NodeEditorLiveTest, testEvaluateInstancesGatesEachInstance)
+{
+    dag::NodeEditorLive sut;
+    auto condition = sut.rootGraph()->node(dagbase::NodeID(sut.createNode("Derived", "derived1").result));
+    auto maths = sut.rootGraph()->node(dagbase::NodeID(sut.createNode("MathsNode", "maths1").result));
+    auto foo = sut.rootGraph()->node(dagbase::NodeID(sut.createNode("FooTyped", "foo1").result));
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.connect(condition->dynamicPort(0)->id(), maths->dynamicPort(0)->id()).status);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.connect(maths->dynamicPort(2)->id(), foo->dynamicPort(0)->id()).status);
+    const std::size_t numInstances = 4;
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.prepareInstances(numInstances).status);
+    std::vector<double> before;
+    for (std::size_t i=0; i<numInstances; ++i)
+    {
+        *sut.instanceDoubles(i, condition->dynamicPort(0)->id()) = 0.1 * double(i + 1);
+        // The trigger is a bool, so it has a value per instance too.
+        auto trigger = sut.instanceBools(i, condition->dynamicPort(1)->id());
+        ASSERT_NE(nullptr, trigger);
+        *trigger = i % 2 == 0;
+        before.emplace_back(*sut.instanceDoubles(i, foo->dynamicPort(0)->id()));
+    }
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.evaluateInstances().status);
+    for (std::size_t i=0; i<numInstances; ++i)
+    {
+        // A closed gate keeps the outputs of that instance only.
+        const double expected = i % 2 == 0 ? std::sin(0.1 * double(i + 1)) : before[i];
+        EXPECT_EQ(expected, *sut.instanceDoubles(i, foo->dynamicPort(0)->id())) << i;
+    }
+}
+
+TEST(NodeEditorLiveTest, testEvaluateInstancesKeepsDelayPerInstance)
+{
+    dag::NodeEditorLive sut;
+    auto delay = sut.rootGraph()->node(dagbase::NodeID(sut.createNode("Delay", "delay1").result));
+    auto maths = sut.rootGraph()->node(dagbase::NodeID(sut.createNode("MathsNode", "maths1").result));
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.connect(delay->dynamicPort(1)->id(), maths->dynamicPort(0)->id()).status);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.connect(maths->dynamicPort(2)->id(), delay->dynamicPort(0)->id()).status);
+    const std::size_t numInstances = 3;
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.prepareInstances(numInstances).status);
+    for (std::size_t i=0; i<numInstances; ++i)
+    {
+        *sut.instanceDoubles(i, delay->dynamicPort(0)->id()) = 0.1 * double(i + 1);
+    }
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.evaluateInstances().status);
+    for (std::size_t i=0; i<numInstances; ++i)
+    {
+        EXPECT_EQ(std::sin(0.1 * double(i + 1)), *sut.instanceDoubles(i, maths->dynamicPort(2)->id())) << i;
+    }
+    // Each instance sees its own value from the previous frame.
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.evaluateInstances().status);
+    for (std::size_t i=0; i<numInstances; ++i)
+    {
+        EXPECT_EQ(std::sin(std::sin(0.1 * double(i + 1))), *sut.instanceDoubles(i, maths->dynamicPort(2)->id())) << i;
+    }
+}
+
+TEST(BoundaryTest, testUpdateCopiesInputsToPartners)
+{
+    dag::MemoryNodeLibrary nodeLib;
+    dag::Boundary sut(nodeLib, "boundary");
+    auto out1 = new dagbase::TypedPort<double>(dagbase::PortID(0), nullptr, "out1", dagbase::PortType::TYPE_DOUBLE, dagbase::PortDirection::DIR_OUT, 0.0);
+    auto in1 = new dagbase::TypedPort<double>(dagbase::PortID(1), nullptr, "in1", dagbase::PortType::TYPE_DOUBLE, dagbase::PortDirection::DIR_IN, 2.0);
+    auto in2 = new dagbase::TypedPort<double>(dagbase::PortID(2), nullptr, "in2", dagbase::PortType::TYPE_DOUBLE, dagbase::PortDirection::DIR_IN, 3.0);
+    auto out2 = new dagbase::TypedPort<double>(dagbase::PortID(3), nullptr, "out2", dagbase::PortType::TYPE_DOUBLE, dagbase::PortDirection::DIR_OUT, 0.0);
+    sut.addDynamicPort(out1, dagbase::MetaPort::FLAGS_OWN_BIT);
+    sut.addDynamicPort(in1, dagbase::MetaPort::FLAGS_OWN_BIT);
+    sut.addDynamicPort(in2, dagbase::MetaPort::FLAGS_OWN_BIT);
+    sut.addDynamicPort(out2, dagbase::MetaPort::FLAGS_OWN_BIT);
+    EXPECT_EQ(out1, sut.partner(*in1));
+    EXPECT_EQ(in2, sut.partner(*out2));
+    sut.update();
+    EXPECT_EQ(2.0, out1->value());
+    EXPECT_EQ(3.0, out2->value());
+}
+
+TEST(NodeEditorLiveTest, testEvaluateDataflow)
+{
+    dag::NodeEditorLive sut;
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.load("etc/tests/Graph/constraints.lua").status);
+    sut.setNumThreads(4);
+    sut.setScheduler(dag::EvaluationPlan::SCHEDULER_DATAFLOW);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.evaluate().status);
+    ASSERT_EQ(dagbase::Status::STATUS_OK, sut.evaluate().status);
+    auto actualPort = dynamic_cast<dagbase::TypedPort<double>*>(sut.rootGraph()->node(dagbase::NodeID(0))->dynamicPort(2));
+    ASSERT_NE(nullptr, actualPort);
+    EXPECT_EQ(1.0, actualPort->value());
+}
+
 class Graph_copy : public ::testing::TestWithParam<std::tuple<const char*, dagbase::CopyOp, bool>>
 {
 